@@ -11,6 +11,8 @@
 #include <numeric>
 #include <cstring>
 #include <cmath>
+#include <type_traits>
+#include <vector>
 
 namespace exploration
 {
@@ -108,13 +110,121 @@ namespace exploration
     return S_EXPLORATION_OK;
   }
 
+  namespace details
+  {
+  // Raw float pointers and std::vector<float> iterators are the ranges that are known to be contiguous. They are sent
+  // to the array kernels below instead of the generic iterator loops.
+  template <typename It>
+  struct is_contiguous_float_iterator
+      : std::integral_constant<bool,
+            std::is_same<It, float*>::value || std::is_same<It, const float*>::value ||
+                std::is_same<It, std::vector<float>::iterator>::value ||
+                std::is_same<It, std::vector<float>::const_iterator>::value>
+  {
+  };
+
+  // Does not dereference an empty range, so end iterators of empty vectors are safe to pass.
+  template <typename It>
+  auto range_data(It first, It last) -> decltype(&*first)
+  {
+    return first == last ? nullptr : &*first;
+  }
+
+  // Four independent accumulators remove the loop carried dependency so the loop maps onto vector registers. Max and
+  // min are exact, so the result does not depend on the order of the reduction.
+  template <bool take_max>
+  float extreme_score(const float* scores, size_t num_scores)
+  {
+    float lanes[4] = {scores[0], scores[0], scores[0], scores[0]};
+    size_t i = 0;
+    for (; i + 4 <= num_scores; i += 4)
+    {
+      for (size_t l = 0; l < 4; ++l)
+      {
+        const float s = scores[i + l];
+        lanes[l] = (take_max ? s > lanes[l] : s < lanes[l]) ? s : lanes[l];
+      }
+    }
+    for (; i < num_scores; ++i)
+    {
+      const float s = scores[i];
+      lanes[0] = (take_max ? s > lanes[0] : s < lanes[0]) ? s : lanes[0];
+    }
+
+    const float a = (take_max ? lanes[0] > lanes[1] : lanes[0] < lanes[1]) ? lanes[0] : lanes[1];
+    const float b = (take_max ? lanes[2] > lanes[3] : lanes[2] < lanes[3]) ? lanes[2] : lanes[3];
+    return (take_max ? a > b : a < b) ? a : b;
+  }
+
+  inline void scale(float* pmf, size_t num_actions, float factor)
+  {
+    for (size_t i = 0; i < num_actions; ++i) { pmf[i] *= factor; }
+  }
+  }  // namespace details
+
+  // Contiguous version of generate_softmax. The exponentials are written and summed in one pass after the max pass, and
+  // the normalization is a multiplication by the inverse norm. scores and pmf may be the same array.
+  inline int generate_softmax(float lambda, const float* scores, size_t num_scores, float* pmf, size_t num_pmf)
+  {
+    const size_t num_actions = std::min(num_scores, num_pmf);
+    for (size_t i = num_actions; i < num_pmf; ++i) { pmf[i] = 0.f; }
+    if (num_actions == 0) return E_EXPLORATION_BAD_RANGE;
+
+    const float max_score = lambda > 0 ? details::extreme_score<true>(scores, num_actions)
+                                       : details::extreme_score<false>(scores, num_actions);
+
+    float norm[4] = {0.f, 0.f, 0.f, 0.f};
+    size_t i = 0;
+    for (; i + 4 <= num_actions; i += 4)
+    {
+      for (size_t l = 0; l < 4; ++l)
+      {
+        const float prob = std::exp(lambda * (scores[i + l] - max_score));
+        pmf[i + l] = prob;
+        norm[l] += prob;
+      }
+    }
+    for (; i < num_actions; ++i)
+    {
+      const float prob = std::exp(lambda * (scores[i] - max_score));
+      pmf[i] = prob;
+      norm[0] += prob;
+    }
+
+    details::scale(pmf, num_actions, 1.f / ((norm[0] + norm[1]) + (norm[2] + norm[3])));
+    return S_EXPLORATION_OK;
+  }
+
+  namespace details
+  {
   template <typename InputIt, typename OutputIt>
-  int generate_softmax(float lambda, InputIt scores_first, InputIt scores_last, OutputIt pmf_first, OutputIt pmf_last)
+  int generate_softmax(float lambda, InputIt scores_first, InputIt scores_last, OutputIt pmf_first, OutputIt pmf_last,
+      std::true_type /* contiguous */)
+  {
+    if (scores_last < scores_first || pmf_last < pmf_first) return E_EXPLORATION_BAD_RANGE;
+    return exploration::generate_softmax(lambda, range_data(scores_first, scores_last),
+        static_cast<size_t>(scores_last - scores_first), range_data(pmf_first, pmf_last),
+        static_cast<size_t>(pmf_last - pmf_first));
+  }
+
+  template <typename InputIt, typename OutputIt>
+  int generate_softmax(float lambda, InputIt scores_first, InputIt scores_last, OutputIt pmf_first, OutputIt pmf_last,
+      std::false_type /* contiguous */)
   {
     typedef typename std::iterator_traits<InputIt>::iterator_category scores_category;
     typedef typename std::iterator_traits<OutputIt>::iterator_category pmf_category;
 
-    return generate_softmax(lambda, scores_first, scores_last, scores_category(), pmf_first, pmf_last, pmf_category());
+    return exploration::generate_softmax(
+        lambda, scores_first, scores_last, scores_category(), pmf_first, pmf_last, pmf_category());
+  }
+  }  // namespace details
+
+  template <typename InputIt, typename OutputIt>
+  int generate_softmax(float lambda, InputIt scores_first, InputIt scores_last, OutputIt pmf_first, OutputIt pmf_last)
+  {
+    using contiguous = std::integral_constant<bool, details::is_contiguous_float_iterator<InputIt>::value &&
+            details::is_contiguous_float_iterator<OutputIt>::value>;
+    return details::generate_softmax(lambda, scores_first, scores_last, pmf_first, pmf_last, contiguous());
   }
 
   template <typename InputIt, typename OutputIt>
@@ -280,22 +390,93 @@ namespace exploration
   // Warning: `seed` must be sufficiently random for the PRNG to produce uniform random values. Using sequential seeds
   // will result in a very biased distribution. If unsure how to update seed between calls, merand48 (in rand48.h) can
   // be used to inplace mutate it.
+  // Contiguous version of sample_after_normalizing. The scan stops at the chosen index and the normalization is a
+  // separate multiplication pass instead of a division inside the scan.
+  inline int sample_after_normalizing(uint64_t seed, float* pmf, size_t num_actions, uint32_t& chosen_index)
+  {
+    if (num_actions == 0) return E_EXPLORATION_BAD_RANGE;
+
+    float total[4] = {0.f, 0.f, 0.f, 0.f};
+    size_t i = 0;
+    for (; i + 4 <= num_actions; i += 4)
+    {
+      for (size_t l = 0; l < 4; ++l)
+      {
+        pmf[i + l] = pmf[i + l] < 0 ? 0.f : pmf[i + l];
+        total[l] += pmf[i + l];
+      }
+    }
+    for (; i < num_actions; ++i)
+    {
+      pmf[i] = pmf[i] < 0 ? 0.f : pmf[i];
+      total[0] += pmf[i];
+    }
+    const float sum_total = (total[0] + total[1]) + (total[2] + total[3]);
+
+    // assume the first is the best
+    if (sum_total == 0)
+    {
+      chosen_index = 0;
+      *pmf = 1;
+      return S_EXPLORATION_OK;
+    }
+
+    float draw = sum_total * uniform_random_merand48(seed);
+    if (draw > sum_total)  // make very sure that draw can not be greater than total.
+      draw = sum_total;
+
+    float sum = 0.f;
+    for (i = 0; i < num_actions; ++i)
+    {
+      sum += pmf[i];
+      if (sum > draw) break;
+    }
+    // The running sum may round below the total, fall back to the last action with mass.
+    if (i == num_actions)
+    {
+      i = num_actions - 1;
+      while (i > 0 && pmf[i] == 0) --i;
+    }
+    chosen_index = static_cast<uint32_t>(i);
+
+    details::scale(pmf, num_actions, 1.f / sum_total);
+    return S_EXPLORATION_OK;
+  }
+
+  namespace details
+  {
   template <typename It>
-  int sample_after_normalizing(uint64_t seed, It pmf_first, It pmf_last, uint32_t& chosen_index)
+  int sample_after_normalizing(uint64_t seed, It pmf_first, It pmf_last, uint32_t& chosen_index, std::true_type)
+  {
+    if (pmf_first == pmf_last || pmf_last < pmf_first) return E_EXPLORATION_BAD_RANGE;
+    return exploration::sample_after_normalizing(
+        seed, range_data(pmf_first, pmf_last), static_cast<size_t>(pmf_last - pmf_first), chosen_index);
+  }
+
+  template <typename It>
+  int sample_after_normalizing(uint64_t seed, It pmf_first, It pmf_last, uint32_t& chosen_index, std::false_type)
   {
     typedef typename std::iterator_traits<It>::iterator_category pmf_category;
-    return sample_after_normalizing(seed, pmf_first, pmf_last, chosen_index, pmf_category());
+    return exploration::sample_after_normalizing(seed, pmf_first, pmf_last, chosen_index, pmf_category());
+  }
+  }  // namespace details
+
+  template <typename It>
+  int sample_after_normalizing(uint64_t seed, It pmf_first, It pmf_last, uint32_t& chosen_index)
+  {
+    return details::sample_after_normalizing(
+        seed, pmf_first, pmf_last, chosen_index, details::is_contiguous_float_iterator<It>());
   }
 
   // Warning: `seed` must be sufficiently random for the PRNG to produce uniform random values. Using sequential seeds
   // will result in a very biased distribution.
   // If unsure how to update seed between calls, merand48 (in rand48.h) can be used to inplace mutate it.
   template <typename It>
-  int sample_after_normalizing(
-      const char* seed, It pmf_first, It pmf_last, uint32_t& chosen_index, std::random_access_iterator_tag pmf_category)
+  int sample_after_normalizing(const char* seed, It pmf_first, It pmf_last, uint32_t& chosen_index,
+      std::random_access_iterator_tag /* pmf_category */)
   {
     uint64_t seed_hash = uniform_hash(seed, strlen(seed), 0);
-    return sample_after_normalizing(seed_hash, pmf_first, pmf_last, chosen_index, pmf_category);
+    return sample_after_normalizing(seed_hash, pmf_first, pmf_last, chosen_index);
   }
 
   // Warning: `seed` must be sufficiently random for the PRNG to produce uniform random values. Using sequential seeds
@@ -246,6 +246,8 @@ public:
 
   static void trace_listener_py(void* wrapper, const std::string& message)
   {
+    // Messages may come from code that released the GIL, such as learn_csr.
+    PyGILState_STATE gil_state = PyGILState_Ensure();
     try
     {
       auto inst = static_cast<py_log_wrapper*>(wrapper);
@@ -258,6 +260,7 @@ public:
       PyErr_Clear();
       std::cerr << "error using python logging. ignoring." << std::endl;
     }
+    PyGILState_Release(gil_state);
   }
 };
 
@@ -745,6 +748,171 @@ bool ex_pop_namespace(example_ptr ec)
 
 void my_setup_example(vw_ptr vw, example_ptr ec) { VW::setup_example(*vw, ec.get()); }
 
+// The memory of a Python object supporting the buffer protocol, such as a NumPy array, without copying it.
+class py_buffer
+{
+public:
+  py_buffer(const py::object& obj, const char* name, bool writable) : _name(name)
+  {
+    const int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+    if (PyObject_GetBuffer(obj.ptr(), &_view, flags) != 0)
+    {
+      PyErr_Clear();
+      THROW(_name << " must be a contiguous" << (writable ? " writable" : "") << " array");
+    }
+    // Skip the byte order prefix, only native arrays are accepted.
+    _format = _view.format[0] == '@' || _view.format[0] == '=' || _view.format[0] == '<' ? _view.format[1]
+                                                                                         : _view.format[0];
+  }
+  ~py_buffer() { PyBuffer_Release(&_view); }
+  py_buffer(const py_buffer&) = delete;
+  py_buffer& operator=(const py_buffer&) = delete;
+
+  size_t size() const { return static_cast<size_t>(_view.len / _view.itemsize); }
+
+  uint64_t get_index(size_t i) const
+  {
+    switch (_format)
+    {
+      case 'i':
+        return static_cast<uint64_t>(static_cast<const int32_t*>(_view.buf)[i]);
+      case 'I':
+        return static_cast<const uint32_t*>(_view.buf)[i];
+      case 'l':
+      case 'q':
+        if (_view.itemsize == 8) { return static_cast<uint64_t>(static_cast<const int64_t*>(_view.buf)[i]); }
+        return static_cast<uint64_t>(static_cast<const int32_t*>(_view.buf)[i]);
+      case 'L':
+      case 'Q':
+        if (_view.itemsize == 8) { return static_cast<const uint64_t*>(_view.buf)[i]; }
+        return static_cast<const uint32_t*>(_view.buf)[i];
+      default:
+        THROW(_name << " must be an integer array, not format " << _view.format);
+    }
+  }
+
+  float get_value(size_t i) const
+  {
+    switch (_format)
+    {
+      case 'f':
+        return static_cast<const float*>(_view.buf)[i];
+      case 'd':
+        return static_cast<float>(static_cast<const double*>(_view.buf)[i]);
+      case 'i':
+        return static_cast<float>(static_cast<const int32_t*>(_view.buf)[i]);
+      case 'l':
+      case 'q':
+        if (_view.itemsize == 8) { return static_cast<float>(static_cast<const int64_t*>(_view.buf)[i]); }
+        return static_cast<float>(static_cast<const int32_t*>(_view.buf)[i]);
+      default:
+        return static_cast<float>(get_index(i));
+    }
+  }
+
+  void set_value(size_t i, float value)
+  {
+    switch (_format)
+    {
+      case 'f':
+        static_cast<float*>(_view.buf)[i] = value;
+        break;
+      case 'd':
+        static_cast<double*>(_view.buf)[i] = value;
+        break;
+      default:
+        THROW(_name << " must be a float32 or float64 array, not format " << _view.format);
+    }
+  }
+
+private:
+  const char* _name;
+  Py_buffer _view;
+  char _format;
+};
+
+// Learns (if labels is not None) or predicts the rows of a CSR matrix, the arrays indptr, indices and data of a
+// scipy.sparse.csr_matrix. Column j of the namespace becomes feature j + hash of the namespace, which is also the
+// hash of the feature named j in text input. The prediction of every row is written to predictions.
+void my_learn_csr(vw_ptr all, py::object indptr_obj, py::object indices_obj, py::object data_obj,
+    py::object labels_obj, py::object weights_obj, py::object predictions_obj, const std::string& ns)
+{
+  if (all->l->is_multiline()) { THROW("learn_csr does not support multiline learners"); }
+  const auto label_type = all->example_parser->lbl_parser.label_type;
+  if (label_type != VW::label_type_t::simple && label_type != VW::label_type_t::multiclass)
+  { THROW("learn_csr supports simple and multiclass labels, not " << VW::to_string(label_type)); }
+
+  py_buffer indptr(indptr_obj, "indptr", false);
+  py_buffer indices(indices_obj, "indices", false);
+  py_buffer data(data_obj, "data", false);
+  py_buffer predictions(predictions_obj, "predictions", true);
+  std::unique_ptr<py_buffer> labels;
+  std::unique_ptr<py_buffer> weights;
+  if (!labels_obj.is_none()) { labels.reset(new py_buffer(labels_obj, "labels", false)); }
+  if (!weights_obj.is_none()) { weights.reset(new py_buffer(weights_obj, "weights", false)); }
+
+  const size_t num_rows = indptr.size() == 0 ? 0 : indptr.size() - 1;
+  if (indices.size() != data.size()) { THROW("indices and data must have the same length"); }
+  if (num_rows > 0 && indptr.get_index(num_rows) > indices.size()) { THROW("indptr points past the end of indices"); }
+  if (predictions.size() < num_rows) { THROW("predictions must have a value for each of the " << num_rows << " rows"); }
+  if (labels && labels->size() < num_rows)
+  { THROW("labels must have a value for each of the " << num_rows << " rows"); }
+  if (weights && weights->size() < num_rows)
+  { THROW("weights must have a value for each of the " << num_rows << " rows"); }
+
+  const unsigned char ns_index = ns.empty() ? ' ' : static_cast<unsigned char>(ns[0]);
+  const uint64_t ns_hash = VW::hash_space(*all, ns);
+  const bool multiclass = label_type == VW::label_type_t::multiclass;
+  const bool multiclass_prediction = all->l->get_output_prediction_type() == VW::prediction_type_t::multiclass;
+  auto* learner = as_singleline(all->l);
+
+  std::unique_ptr<VW::example> ec(new VW::example);
+  ec->interactions = &all->interactions;
+  ec->extent_interactions = &all->extent_interactions;
+
+  // Nothing below touches Python objects, so other Python threads can run meanwhile.
+  PyThreadState* thread_state = PyEval_SaveThread();
+  try
+  {
+    for (size_t row = 0; row < num_rows; row++)
+    {
+      all->example_parser->lbl_parser.default_label(ec->l);
+      const float weight = weights ? weights->get_value(row) : 1.f;
+      if (labels && multiclass)
+      {
+        ec->l.multi.label = static_cast<uint32_t>(labels->get_index(row));
+        ec->l.multi.weight = weight;
+      }
+      else if (labels)
+      {
+        ec->l.simple.label = labels->get_value(row);
+        ec->_reduction_features.template get<simple_label_reduction_features>().weight = weight;
+      }
+
+      ec->indices.push_back(ns_index);
+      auto& fs = ec->feature_space[ns_index];
+      for (uint64_t j = indptr.get_index(row), end = indptr.get_index(row + 1); j < end; j++)
+      { fs.push_back(data.get_value(j), (indices.get_index(j) + ns_hash) & all->parse_mask); }
+      VW::setup_example(*all, ec.get());
+
+      if (labels) { all->learn(*ec); }
+      else
+      {
+        learner->predict(*ec);
+      }
+      predictions.set_value(row, multiclass_prediction ? static_cast<float>(ec->pred.multiclass) : ec->pred.scalar);
+
+      VW::empty_example(*all, *ec);
+    }
+  }
+  catch (...)
+  {
+    PyEval_RestoreThread(thread_state);
+    throw;
+  }
+  PyEval_RestoreThread(thread_state);
+}
+
 void unsetup_example(vw_ptr vwP, example_ptr ae)
 {
   VW::workspace& all = *vwP;
@@ -1329,6 +1497,8 @@ BOOST_PYTHON_MODULE(pylibvw)
       .def("save", &my_save, "save model to filename")
       .def("learn", &my_learn, "given a pyvw example, learn (and predict) on that example")
       .def("predict", &my_predict, "given a pyvw example, predict on that example")
+      .def("_learn_csr", &my_learn_csr,
+          "learn (given labels) or predict on the rows of a CSR matrix given by its indptr, indices and data arrays")
       .def("hash_space", &VW::hash_space, "given a namespace (as a string), compute the hash of that namespace")
       .def("hash_feature", &VW::hash_feature,
           "given a feature string (arg2) and a hashed namespace (arg3), hash that feature")
@@ -657,3 +657,37 @@ def test_deceprecated_labels():
         vowpalwabbit.pyvw.multiclass_probabilities_label()
         vowpalwabbit.pyvw.cost_sensitive_label()
         vowpalwabbit.pyvw.cbandits_label()
+
+
+def test_learn_csr_matches_text_examples():
+    np = pytest.importorskip("numpy")
+    sparse = pytest.importorskip("scipy.sparse")
+
+    X = sparse.csr_matrix(
+        np.array([[1.0, 0.0, 2.0], [0.0, 0.5, 0.0], [0.0, 0.0, 0.0], [3.0, 1.0, 0.0]])
+    )
+    y = np.array([1.0, -1.0, 1.0, -1.0])
+    lines = ["1 |f 0:1 2:2", "-1 |f 1:0.5", "1 |f", "-1 |f 0:3 1:1"]
+
+    text_model = Workspace(quiet=True)
+    csr_model = Workspace(quiet=True)
+    for _ in range(3):
+        expected = [text_model.learn(line) for line in lines]
+        learned = csr_model.learn_csr(X, y, namespace="f")
+        assert learned.shape == (4,)
+
+    predicted = csr_model.predict_csr((X.indptr, X.indices, X.data), namespace="f")
+    for prediction, line in zip(predicted, lines):
+        assert isclose(prediction, text_model.predict(line.split(" ", 1)[1]))
+
+
+def test_learn_csr_multiclass():
+    np = pytest.importorskip("numpy")
+    sparse = pytest.importorskip("scipy.sparse")
+
+    X = sparse.identity(3, format="csr")
+    y = np.array([1, 2, 3])
+    model = Workspace(oaa=3, quiet=True)
+    for _ in range(10):
+        model.learn_csr(X, y)
+    assert list(model.predict_csr(X)) == [1.0, 2.0, 3.0]
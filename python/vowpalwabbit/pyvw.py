@@ -409,6 +409,13 @@ def _build_command_line(
     return merged_arg_list
 
 
+class _CSRArrays:
+    def __init__(self, indptr, indices, data):
+        self.indptr = indptr
+        self.indices = indices
+        self.data = data
+
+
 class Workspace(pylibvw.vw):
     """Workspace exposes most of the library functionality. It wraps the native code. The Workspace Python class should always be used instead of the binding glue class."""
 
@@ -702,6 +709,68 @@ class Workspace(pylibvw.vw):
 
         return prediction
 
+    def _learn_or_predict_csr(self, X, y, sample_weight, namespace: str):
+        import numpy as np
+
+        if hasattr(X, "tocsr"):
+            X = X.tocsr()
+        elif isinstance(X, tuple) and len(X) == 3:
+            X = _CSRArrays(*X)
+        else:
+            raise TypeError(
+                "expecting a scipy.sparse matrix or a tuple (indptr, indices, data), got %s"
+                % type(X)
+            )
+
+        # np.ascontiguousarray only copies arrays that are not already contiguous.
+        indptr = np.ascontiguousarray(X.indptr)
+        indices = np.ascontiguousarray(X.indices)
+        data = np.ascontiguousarray(X.data)
+        if data.dtype not in (np.float32, np.float64):
+            data = data.astype(np.float32)
+        if y is not None:
+            y = np.ascontiguousarray(y)
+            if self.get_label_type() == LabelType.MULTICLASS:
+                y = y.astype(np.int64, copy=False)
+            else:
+                y = y.astype(np.float32, copy=False)
+        if sample_weight is not None:
+            sample_weight = np.ascontiguousarray(sample_weight, dtype=np.float32)
+
+        predictions = np.empty(max(len(indptr) - 1, 0), dtype=np.float32)
+        pylibvw.vw._learn_csr(
+            self, indptr, indices, data, y, sample_weight, predictions, namespace
+        )
+        return predictions
+
+    def learn_csr(self, X, y, sample_weight=None, namespace: str = ""):
+        """Learn from every row of a sparse matrix, without creating an Example per row
+
+        The arrays of the matrix are read in place and the GIL is released while learning. Column ``j`` becomes the feature named ``j`` of ``namespace``, so a row learns the same as the text example ``|namespace j:value ...``.
+
+        Args:
+            X: scipy.sparse matrix, converted to CSR if needed, or a tuple of the NumPy arrays (indptr, indices, data) of a CSR matrix
+            y: Label of each row. Floats for simple labels, class numbers for multiclass learners
+            sample_weight: Optional importance weight of each row
+            namespace: Namespace of the features
+
+        Returns:
+            numpy.ndarray: Prediction of each row made while learning. The predicted class for multiclass learners
+        """
+        return self._learn_or_predict_csr(X, y, sample_weight, namespace)
+
+    def predict_csr(self, X, namespace: str = ""):
+        """Predict every row of a sparse matrix, see :py:meth:`~vowpalwabbit.Workspace.learn_csr`
+
+        Args:
+            X: scipy.sparse matrix, converted to CSR if needed, or a tuple of the NumPy arrays (indptr, indices, data) of a CSR matrix
+            namespace: Namespace of the features
+
+        Returns:
+            numpy.ndarray: Prediction of each row. The predicted class for multiclass learners
+        """
+        return self._learn_or_predict_csr(X, None, None, namespace)
+
     def save(self, filename: str) -> None:
         """save model to disk"""
         pylibvw.vw.save(self, filename)
@@ -1,7 +1,14 @@
+#include <cstdlib>
+#include <functional>
+#include <random>
 #include <vector>
 #include <sstream>
 #include <string>
 
+#include <benchmark/benchmark.h>
+
+#include "vw.h"
+
 inline std::string get_x_numerical_fts(int feature_size)
 {
   std::stringstream ss;
@@ -51,4 +58,190 @@ inline std::string get_x_string_fts_multi_ex(
     ss << std::endl;
   }
   return ss.str();
-};
\ No newline at end of file
+};
+
+inline std::vector<std::vector<std::string>> gen_cb_examples(size_t num_examples,  // Total number of multi_ex examples
+    size_t shared_feats_size,                                                      // Number of possible shared features
+    size_t shared_feats_count,    // Number of shared features per multi_ex
+    size_t actions_per_example,   // Number of actions in each multi_ex
+    size_t feature_groups_size,   // Number of possible feature groups
+    size_t feature_groups_count,  // Number of features groups per action
+    size_t action_feats_size,     // Number of possible per-action features
+    size_t action_feats_count,    // Number of actions per feature group per action
+    bool same_first_char          // Flag to keep first character of all feature groups the same
+)
+{
+  srand(0);
+  std::vector<std::vector<std::string>> examples_vec;
+  for (int ex = 0; ex < num_examples; ++ex)
+  {
+    std::vector<std::string> examples;
+    std::ostringstream shared_ss;
+    shared_ss << "shared |";
+    for (int shared_feat = 0; shared_feat < shared_feats_count; ++shared_feat)
+    { shared_ss << " " << (rand() % shared_feats_size); }
+    examples.push_back(shared_ss.str());
+    int action_ind = rand() % actions_per_example;
+    for (int ac = 0; ac < actions_per_example; ++ac)
+    {
+      std::ostringstream action_ss;
+      if (ac == action_ind) { action_ss << action_ind << ":1.0:0.5 "; }
+      for (int fg = 0; fg < feature_groups_count; ++fg)
+      {
+        action_ss << "|";
+        if (same_first_char) { action_ss << "f"; }
+        action_ss << (static_cast<char>(65 + rand() % feature_groups_size)) << " ";
+        for (int action_feat = 0; action_feat < action_feats_count; ++action_feat)
+        { action_ss << (rand() % action_feats_size) << " "; }
+      }
+      examples.push_back(action_ss.str());
+    }
+    examples_vec.push_back(examples);
+  }
+  return examples_vec;
+}
+
+inline std::vector<multi_ex> load_examples(VW::workspace* vw, const std::vector<std::vector<std::string>>& ex_strs)
+{
+  std::vector<multi_ex> examples_vec;
+  for (const auto& ex_str : ex_strs)
+  {
+    multi_ex mxs;
+    for (const auto& example : ex_str) { mxs.push_back(VW::read_example(*vw, example)); }
+    examples_vec.push_back(mxs);
+  }
+  return examples_vec;
+}
+
+// Number of weight bits (-b) the model size benchmarks run with. 2^28 weights take several GB per model, so that size
+// only runs when the benchmarks are configured with -DBUILD_LARGE_MODEL_BENCHMARKS=ON.
+inline void model_bits_args(benchmark::internal::Benchmark* bench)
+{
+  bench->Arg(18)->Arg(24);
+#ifdef VW_LARGE_MODEL_BENCHMARKS
+  bench->Arg(28);
+#endif
+}
+
+// Seed shared by the synthetic data generators below so that every run benchmarks the same data.
+constexpr uint32_t BENCHMARK_DATA_SEED = 42;
+
+using label_generator = std::function<std::string(std::mt19937&)>;
+
+inline label_generator simple_labels()
+{
+  return [](std::mt19937& rng) { return std::string(rng() % 2 == 0 ? "1" : "-1"); };
+}
+
+inline label_generator multiclass_labels(size_t num_classes)
+{
+  return [num_classes](std::mt19937& rng) { return std::to_string(rng() % num_classes + 1); };
+}
+
+inline label_generator cost_sensitive_labels(size_t num_classes, size_t labels_per_example)
+{
+  return [num_classes, labels_per_example](std::mt19937& rng) {
+    std::stringstream ss;
+    for (size_t i = 0; i < labels_per_example; i++)
+    { ss << (i > 0 ? " " : "") << (rng() % num_classes + 1) << ":" << (rng() % 100) / 100.f; }
+    return ss.str();
+  };
+}
+
+inline label_generator multilabel_labels(size_t num_labels, size_t labels_per_example)
+{
+  return [num_labels, labels_per_example](std::mt19937& rng) {
+    std::stringstream ss;
+    for (size_t i = 0; i < labels_per_example; i++) { ss << (i > 0 ? "," : "") << (rng() % num_labels); }
+    return ss.str();
+  };
+}
+
+inline label_generator no_labels()
+{
+  return [](std::mt19937&) { return std::string(); };
+}
+
+// Generates text format examples with namespaces named a, b, c, ... each holding feats_per_namespace
+// features drawn out of feature_space possible numeric feature names.
+inline std::vector<std::string> gen_text_examples(size_t num_examples, size_t num_namespaces,
+    size_t feats_per_namespace, size_t feature_space, const label_generator& gen_label, bool with_values = true)
+{
+  std::mt19937 rng(BENCHMARK_DATA_SEED);
+  std::vector<std::string> examples;
+  examples.reserve(num_examples);
+  for (size_t ex = 0; ex < num_examples; ++ex)
+  {
+    std::stringstream ss;
+    ss << gen_label(rng);
+    for (size_t ns = 0; ns < num_namespaces; ++ns)
+    {
+      ss << " |" << static_cast<char>('a' + ns);
+      for (size_t ft = 0; ft < feats_per_namespace; ++ft)
+      {
+        ss << " " << (rng() % feature_space);
+        if (with_values) { ss << ":" << (rng() % 1000 + 1) / 1000.f; }
+      }
+    }
+    examples.push_back(ss.str());
+  }
+  return examples;
+}
+
+// Generates simple label examples in the --json format, with the same shape as gen_text_examples.
+inline std::vector<std::string> gen_json_examples(
+    size_t num_examples, size_t num_namespaces, size_t feats_per_namespace, size_t feature_space)
+{
+  std::mt19937 rng(BENCHMARK_DATA_SEED);
+  std::vector<std::string> examples;
+  examples.reserve(num_examples);
+  for (size_t ex = 0; ex < num_examples; ++ex)
+  {
+    std::stringstream ss;
+    ss << R"({"_label":)" << (rng() % 2 == 0 ? 1 : -1);
+    for (size_t ns = 0; ns < num_namespaces; ++ns)
+    {
+      ss << R"(,")" << static_cast<char>('a' + ns) << R"(":{)";
+      for (size_t ft = 0; ft < feats_per_namespace; ++ft)
+      { ss << (ft > 0 ? "," : "") << '"' << (rng() % feature_space) << R"(":)" << (rng() % 1000 + 1) / 1000.f; }
+      ss << "}";
+    }
+    ss << "}";
+    examples.push_back(ss.str());
+  }
+  return examples;
+}
+
+// Generates contextual bandit interactions in the --dsjson format.
+inline std::vector<std::string> gen_dsjson_examples(
+    size_t num_examples, size_t num_actions, size_t shared_feats, size_t action_feats, size_t feature_space)
+{
+  std::mt19937 rng(BENCHMARK_DATA_SEED);
+  std::vector<std::string> examples;
+  examples.reserve(num_examples);
+  for (size_t ex = 0; ex < num_examples; ++ex)
+  {
+    const size_t chosen = rng() % num_actions;
+    std::stringstream ss;
+    ss << R"({"_label_cost":)" << -static_cast<float>(rng() % 2) << R"(,"_label_probability":)"
+       << 1.f / num_actions << R"(,"_label_Action":)" << chosen + 1 << R"(,"_labelIndex":)" << chosen
+       << R"(,"EventId":"event)" << ex << R"(","a":[)";
+    for (size_t a = 0; a < num_actions; ++a) { ss << (a > 0 ? "," : "") << a + 1; }
+    ss << R"(],"c":{"shared":{)";
+    for (size_t ft = 0; ft < shared_feats; ++ft)
+    { ss << (ft > 0 ? "," : "") << R"("s)" << (rng() % feature_space) << R"(":1)"; }
+    ss << R"(},"_multi":[)";
+    for (size_t a = 0; a < num_actions; ++a)
+    {
+      ss << (a > 0 ? "," : "") << R"({"action":{)";
+      for (size_t ft = 0; ft < action_feats; ++ft)
+      { ss << (ft > 0 ? "," : "") << R"("f)" << (rng() % feature_space) << R"(":1)"; }
+      ss << "}}";
+    }
+    ss << R"(]},"p":[)";
+    for (size_t a = 0; a < num_actions; ++a) { ss << (a > 0 ? "," : "") << 1.f / num_actions; }
+    ss << "]}";
+    examples.push_back(ss.str());
+  }
+  return examples;
+}
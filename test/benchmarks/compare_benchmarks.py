@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+"""Compare two Google Benchmark JSON result files and report regressions.
+
+Usage:
+    ./vw-benchmarks.out --benchmark_out=base.json --benchmark_out_format=json
+    ./vw-benchmarks.out --benchmark_out=new.json --benchmark_out_format=json
+    python3 compare_benchmarks.py base.json new.json --threshold 0.1
+
+Exits with a non-zero status if any benchmark present in both files got slower
+than the threshold (relative change of cpu_time).
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_results(path):
+    with open(path) as f:
+        data = json.load(f)
+    results = {}
+    for bench in data["benchmarks"]:
+        # When repetitions are used only compare the aggregated median.
+        if bench.get("run_type") == "aggregate" and bench.get("aggregate_name") != "median":
+            continue
+        results[bench.get("run_name", bench["name"])] = bench
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="JSON results of the baseline build")
+    parser.add_argument("contender", help="JSON results of the build to check")
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.1,
+        help="Relative cpu_time increase considered a regression (default: 0.1)",
+    )
+    args = parser.parse_args()
+
+    baseline = load_results(args.baseline)
+    contender = load_results(args.contender)
+
+    regressions = []
+    print("{:<70} {:>14} {:>14} {:>9}".format("benchmark", "baseline", "contender", "change"))
+    for name in sorted(baseline.keys() & contender.keys()):
+        base_time = baseline[name]["cpu_time"]
+        new_time = contender[name]["cpu_time"]
+        change = (new_time - base_time) / base_time if base_time > 0 else 0.0
+        unit = contender[name].get("time_unit", "ns")
+        print(
+            "{:<70} {:>12.1f}{:>2} {:>12.1f}{:>2} {:>+8.1%}".format(name, base_time, unit, new_time, unit, change)
+        )
+        if change > args.threshold:
+            regressions.append((name, change))
+
+    for name in sorted(baseline.keys() - contender.keys()):
+        print("{:<70} missing from contender".format(name))
+
+    if regressions:
+        print("\n{} benchmark(s) regressed by more than {:.0%}:".format(len(regressions), args.threshold))
+        for name, change in regressions:
+            print("  {} ({:+.1%})".format(name, change))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
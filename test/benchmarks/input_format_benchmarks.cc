@@ -14,8 +14,12 @@
 #include "cache.h"
 #include "io/io_adapter.h"
 #include "parse_example.h"
+#include "parse_example_json.h"
 #include "parser.h"
 #include "vw.h"
+#ifdef BUILD_FLATBUFFERS
+#  include "parser/flatbuffer/parse_example_flatbuffer.h"
+#endif
 
 std::shared_ptr<std::vector<char>> get_cache_buffer(const std::string& es)
 {
@@ -102,6 +106,166 @@ static void benchmark_example_reuse(benchmark::State& state)
   VW::finish(*vw);
 }
 
+// Parse-only throughput of a whole synthetic dataset, one benchmark per input format. All formats encode
+// examples with the same shape so that items_per_second can be compared across formats.
+static std::vector<std::string> parse_benchmark_dataset()
+{
+  return gen_text_examples(1000, 3, 10, 1 << 20, simple_labels());
+}
+
+static void bench_text_dataset(benchmark::State& state)
+{
+  std::string data;
+  for (const auto& line : parse_benchmark_dataset()) { data += line + "\n"; }
+
+  auto* vw = VW::initialize("--quiet --no_stdin", nullptr, false, nullptr, nullptr);
+  io_buf buffer;
+  buffer.add_file(VW::io::create_buffer_view(data.data(), data.size()));
+  VW::v_array<example*> examples;
+  examples.push_back(&VW::get_unused_example(vw));
+
+  size_t num_examples = 0;
+  for (auto _ : state)
+  {
+    while (vw->example_parser->reader(vw, buffer, examples) > 0)
+    {
+      VW::empty_example(*vw, *examples[0]);
+      num_examples++;
+    }
+    buffer.reset();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(num_examples);
+  VW::finish(*vw);
+}
+
+static void bench_cache_dataset(benchmark::State& state)
+{
+  auto* writer_vw = VW::initialize("--quiet --no_stdin", nullptr, false, nullptr, nullptr);
+  auto cache_buffer = std::make_shared<std::vector<char>>();
+  writer_vw->example_parser->output.add_file(VW::io::create_vector_writer(cache_buffer));
+  VW::details::cache_temp_buffer temp_buf;
+  for (const auto& line : parse_benchmark_dataset())
+  {
+    auto* ae = &VW::get_unused_example(writer_vw);
+    VW::read_line(*writer_vw, ae, const_cast<char*>(line.c_str()));
+    VW::write_example_to_cache(writer_vw->example_parser->output, ae, writer_vw->example_parser->lbl_parser,
+        writer_vw->parse_mask, temp_buf);
+    VW::finish_example(*writer_vw, *ae);
+  }
+  writer_vw->example_parser->output.flush();
+  VW::finish(*writer_vw);
+
+  auto* vw = VW::initialize("--quiet --no_stdin", nullptr, false, nullptr, nullptr);
+  io_buf buffer;
+  buffer.add_file(VW::io::create_buffer_view(cache_buffer->data(), cache_buffer->size()));
+  VW::v_array<example*> examples;
+  examples.push_back(&VW::get_unused_example(vw));
+
+  size_t num_examples = 0;
+  for (auto _ : state)
+  {
+    while (VW::read_example_from_cache(vw, buffer, examples) > 0)
+    {
+      VW::empty_example(*vw, *examples[0]);
+      num_examples++;
+    }
+    buffer.reset();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(num_examples);
+  VW::finish(*vw);
+}
+
+template <bool dsjson>
+static void bench_json_dataset(benchmark::State& state)
+{
+  const auto lines = dsjson ? gen_dsjson_examples(200, 10, 5, 5, 1000) : gen_json_examples(1000, 3, 10, 1 << 20);
+  auto* vw = VW::initialize(dsjson ? "--dsjson --cb_explore_adf --quiet --no_stdin" : "--json --quiet --no_stdin",
+      nullptr, false, nullptr, nullptr);
+  VW::v_array<example*> examples;
+  std::vector<char> line_buffer;
+
+  for (auto _ : state)
+  {
+    for (const auto& line : lines)
+    {
+      // The json parser works in situ, so every iteration needs a fresh copy of the line.
+      line_buffer.assign(line.begin(), line.end());
+      line_buffer.push_back('\0');
+      examples.push_back(&VW::get_unused_example(vw));
+      if (dsjson)
+      {
+        DecisionServiceInteraction interaction;
+        VW::read_line_decision_service_json<false>(*vw, examples, line_buffer.data(), line.size(), false,
+            reinterpret_cast<VW::example_factory_t>(&VW::get_unused_example), vw, &interaction);
+      }
+      else
+      {
+        VW::read_line_json_s<false>(*vw, examples, line_buffer.data(), line.size(),
+            reinterpret_cast<VW::example_factory_t>(&VW::get_unused_example), vw);
+      }
+      for (auto* ex : examples) { VW::finish_example(*vw, *ex); }
+      examples.clear();
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * lines.size());
+  VW::finish(*vw);
+}
+
+#ifdef BUILD_FLATBUFFERS
+static void bench_flatbuffer_dataset(benchmark::State& state)
+{
+  namespace fb = VW::parsers::flatbuffer;
+
+  // Same shape as the text dataset: 3 namespaces of 10 hashed features with a simple label.
+  std::mt19937 rng(BENCHMARK_DATA_SEED);
+  std::vector<std::vector<uint8_t>> buffers;
+  for (size_t ex = 0; ex < 1000; ++ex)
+  {
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<flatbuffers::Offset<fb::Namespace>> namespaces;
+    for (size_t ns = 0; ns < 3; ++ns)
+    {
+      std::vector<flatbuffers::Offset<fb::Feature>> fts;
+      for (size_t ft = 0; ft < 10; ++ft)
+      { fts.push_back(fb::CreateFeatureDirect(builder, nullptr, (rng() % 1000 + 1) / 1000.f, rng() % (1 << 20))); }
+      const std::string ns_name(1, static_cast<char>('a' + ns));
+      namespaces.push_back(fb::CreateNamespaceDirect(builder, ns_name.c_str(), ns_name[0], &fts));
+    }
+    auto label = fb::CreateSimpleLabel(builder, rng() % 2 == 0 ? 1.f : -1.f, 1.f).Union();
+    auto example = fb::CreateExampleDirect(builder, &namespaces, fb::Label_SimpleLabel, label);
+    builder.FinishSizePrefixed(fb::CreateExampleRoot(builder, fb::ExampleType_Example, example.Union()));
+    buffers.emplace_back(builder.GetBufferPointer(), builder.GetBufferPointer() + builder.GetSize());
+  }
+
+  auto* vw = VW::initialize("--flatbuffer --quiet --no_stdin", nullptr, false, nullptr, nullptr);
+  io_buf unused_buffer;
+  VW::v_array<example*> examples;
+  examples.push_back(&VW::get_unused_example(vw));
+
+  for (auto _ : state)
+  {
+    for (auto& buffer : buffers)
+    {
+      vw->flat_converter->parse_examples(vw, unused_buffer, examples, buffer.data());
+      VW::empty_example(*vw, *examples[0]);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * buffers.size());
+  VW::finish(*vw);
+}
+
+BENCHMARK(bench_flatbuffer_dataset);
+#endif
+
+BENCHMARK(bench_text_dataset);
+BENCHMARK(bench_cache_dataset);
+BENCHMARK_TEMPLATE(bench_json_dataset, false)->Name("bench_json_dataset");
+BENCHMARK_TEMPLATE(bench_json_dataset, true)->Name("bench_dsjson_dataset");
+
 BENCHMARK_CAPTURE(bench_cache_io_buf, 120_string_fts, get_x_string_fts(120));
 BENCHMARK_CAPTURE(bench_text_io_buf, 120_string_fts, get_x_string_fts(120));
 
@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmarks_common.h"
+#include "io/io_adapter.h"
+#include "learner.h"
+#include "vw.h"
+
+// Batch learners and model serialization. These use workspace internals (end_pass, io_buf) so they are not
+// part of the standalone benchmarks.
+
+static void bench_bfgs(benchmark::State& state, const std::string& cmd)
+{
+  const auto example_strings = gen_text_examples(200, 3, 10, 1 << 16, simple_labels());
+  auto* vw = VW::initialize(cmd + " --quiet --holdout_off", nullptr, false, nullptr, nullptr);
+  std::vector<example*> examples;
+  for (const auto& example_string : example_strings) { examples.push_back(VW::read_example(*vw, example_string)); }
+
+  // One iteration is a full pass over the data, including the end of pass line search.
+  for (auto _ : state)
+  {
+    for (auto* ex : examples) { vw->learn(*ex); }
+    vw->current_pass++;
+    vw->l->end_pass();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * examples.size());
+
+  for (auto* ex : examples) { vw->finish_example(*ex); }
+  VW::finish(*vw);
+}
+
+static std::shared_ptr<std::vector<char>> train_and_save_model(const std::string& cmd)
+{
+  auto* vw = VW::initialize(cmd + " --quiet", nullptr, false, nullptr, nullptr);
+  for (const auto& example_string : gen_text_examples(200, 3, 10, 1 << 20, simple_labels()))
+  {
+    auto* ex = VW::read_example(*vw, example_string);
+    vw->learn(*ex);
+    vw->finish_example(*ex);
+  }
+
+  auto model_buffer = std::make_shared<std::vector<char>>();
+  io_buf buffer;
+  buffer.add_file(VW::io::create_vector_writer(model_buffer));
+  VW::save_predictor(*vw, buffer);
+  VW::finish(*vw);
+  return model_buffer;
+}
+
+// The number of bits is taken from the benchmark argument.
+static void bench_model_save(benchmark::State& state, const std::string& cmd)
+{
+  const std::string full_cmd = cmd + " --quiet -b " + std::to_string(state.range(0));
+  auto* vw = VW::initialize(full_cmd, nullptr, false, nullptr, nullptr);
+  size_t model_size = 0;
+  for (auto _ : state)
+  {
+    auto model_buffer = std::make_shared<std::vector<char>>();
+    io_buf buffer;
+    buffer.add_file(VW::io::create_vector_writer(model_buffer));
+    VW::save_predictor(*vw, buffer);
+    model_size = model_buffer->size();
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * model_size);
+  VW::finish(*vw);
+}
+
+static void bench_model_load(benchmark::State& state, const std::string& cmd)
+{
+  const std::string full_cmd = cmd + " --quiet -b " + std::to_string(state.range(0));
+  const auto model_buffer = train_and_save_model(full_cmd);
+  for (auto _ : state)
+  {
+    io_buf buffer;
+    buffer.add_file(VW::io::create_buffer_view(model_buffer->data(), model_buffer->size()));
+    auto* vw = VW::initialize("--quiet", &buffer, false, nullptr, nullptr);
+    benchmark::DoNotOptimize(vw);
+    VW::finish(*vw);
+  }
+  state.SetBytesProcessed(state.iterations() * model_buffer->size());
+}
+
+BENCHMARK_CAPTURE(bench_bfgs, bfgs, "--bfgs --mem 5");
+BENCHMARK_CAPTURE(bench_bfgs, bfgs_quadratic, "--bfgs --mem 5 -q ab");
+
+BENCHMARK_CAPTURE(bench_model_save, gd, "")->Apply(model_bits_args);
+BENCHMARK_CAPTURE(bench_model_save, gd_save_resume, "--save_resume")->Arg(18)->Arg(24);
+BENCHMARK_CAPTURE(bench_model_load, gd, "")->Apply(model_bits_args);
@@ -111,47 +111,6 @@ static void benchmark_ccb_adf_learn(benchmark::State& state, std::string feature
   VW::finish(*vw);
 }
 
-static std::vector<std::vector<std::string>> gen_cb_examples(size_t num_examples,  // Total number of multi_ex examples
-    size_t shared_feats_size,                                                      // Number of possible shared features
-    size_t shared_feats_count,    // Number of shared features per multi_ex
-    size_t actions_per_example,   // Number of actions in each multi_ex
-    size_t feature_groups_size,   // Number of possible feature groups
-    size_t feature_groups_count,  // Number of features groups per action
-    size_t action_feats_size,     // Number of possible per-action features
-    size_t action_feats_count,    // Number of actions per feature group per action
-    bool same_first_char          // Flag to keep first character of all feature groups the same
-)
-{
-  srand(0);
-  std::vector<std::vector<std::string>> examples_vec;
-  for (int ex = 0; ex < num_examples; ++ex)
-  {
-    std::vector<std::string> examples;
-    std::ostringstream shared_ss;
-    shared_ss << "shared |";
-    for (int shared_feat = 0; shared_feat < shared_feats_count; ++shared_feat)
-    { shared_ss << " " << (rand() % shared_feats_size); }
-    examples.push_back(shared_ss.str());
-    int action_ind = rand() % actions_per_example;
-    for (int ac = 0; ac < actions_per_example; ++ac)
-    {
-      std::ostringstream action_ss;
-      if (ac == action_ind) { action_ss << action_ind << ":1.0:0.5 "; }
-      for (int fg = 0; fg < feature_groups_count; ++fg)
-      {
-        action_ss << "|";
-        if (same_first_char) { action_ss << "f"; }
-        action_ss << (static_cast<char>(65 + rand() % feature_groups_size)) << " ";
-        for (int action_feat = 0; action_feat < action_feats_count; ++action_feat)
-        { action_ss << (rand() % action_feats_size) << " "; }
-      }
-      examples.push_back(action_ss.str());
-    }
-    examples_vec.push_back(examples);
-  }
-  return examples_vec;
-}
-
 static std::vector<std::vector<std::string>> gen_ccb_examples(size_t num_examples,  // Total number of multi_ex examples
     size_t shared_feats_size,     // Number of possible shared features
     size_t shared_feats_count,    // Number of shared features per multi_ex
@@ -207,18 +166,6 @@ static std::vector<std::vector<std::string>> gen_ccb_examples(size_t num_example
   return examples_vec;
 }
 
-static std::vector<multi_ex> load_examples(VW::workspace* vw, const std::vector<std::vector<std::string>>& ex_strs)
-{
-  std::vector<multi_ex> examples_vec;
-  for (const auto& ex_str : ex_strs)
-  {
-    multi_ex mxs;
-    for (const auto& example : ex_str) { mxs.push_back(VW::read_example(*vw, example)); }
-    examples_vec.push_back(mxs);
-  }
-  return examples_vec;
-}
-
 static void benchmark_multi(
     benchmark::State& state, const std::vector<std::vector<std::string>>& examples_str, const std::string& cmd)
 {
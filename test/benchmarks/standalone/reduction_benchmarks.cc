@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "../benchmarks_common.h"
+#include "vw.h"
+
+// End to end learn and predict throughput of common reduction stacks over deterministic synthetic data.
+// Items processed are examples (or multi_ex for ADF reductions), so the reported items_per_second is
+// directly comparable between builds.
+
+static std::vector<example*> read_examples(VW::workspace& vw, const std::vector<std::string>& example_strings)
+{
+  std::vector<example*> examples;
+  examples.reserve(example_strings.size());
+  for (const auto& example_string : example_strings) { examples.push_back(VW::read_example(vw, example_string)); }
+  return examples;
+}
+
+template <bool is_learn>
+static void bench_single_line(benchmark::State& state, const std::string& cmd, std::vector<std::string> example_strings)
+{
+  auto* vw = VW::initialize(cmd + " --quiet", nullptr, false, nullptr, nullptr);
+  auto examples = read_examples(*vw, example_strings);
+
+  for (auto _ : state)
+  {
+    for (auto* ex : examples)
+    {
+      if (is_learn) { vw->learn(*ex); }
+      else
+      {
+        vw->predict(*ex);
+      }
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * examples.size());
+
+  for (auto* ex : examples) { vw->finish_example(*ex); }
+  VW::finish(*vw);
+}
+
+// The number of bits is taken from the benchmark argument, so one capture covers every model size.
+static void bench_gd_learn(benchmark::State& state, const std::string& cmd)
+{
+  const auto examples = gen_text_examples(100, 3, 10, 1 << 20, simple_labels());
+  bench_single_line<true>(state, cmd + " -b " + std::to_string(state.range(0)), examples);
+}
+
+static void bench_gd_predict(benchmark::State& state, const std::string& cmd)
+{
+  const auto examples = gen_text_examples(100, 3, 10, 1 << 20, simple_labels());
+  bench_single_line<false>(state, cmd + " -b " + std::to_string(state.range(0)), examples);
+}
+
+static void bench_multiclass(benchmark::State& state, const std::string& cmd, const label_generator& gen_label)
+{
+  const auto examples = gen_text_examples(100, 2, 10, 1 << 16, gen_label);
+  bench_single_line<true>(state, cmd, examples);
+}
+
+static void bench_multiclass_predict(benchmark::State& state, const std::string& cmd, const label_generator& gen_label)
+{
+  const auto examples = gen_text_examples(100, 2, 10, 1 << 16, gen_label);
+  bench_single_line<false>(state, cmd, examples);
+}
+
+static void bench_cb_explore_adf(benchmark::State& state, const std::string& exploration)
+{
+  auto* vw = VW::initialize("--cb_explore_adf --quiet -q :: " + exploration, nullptr, false, nullptr, nullptr);
+  auto examples_vec = load_examples(vw, gen_cb_examples(50, 50, 5, 10, 3, 2, 100, 4, false));
+
+  for (auto _ : state)
+  {
+    for (auto& examples : examples_vec) { vw->learn(examples); }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * examples_vec.size());
+
+  for (auto& examples : examples_vec) { vw->finish_example(examples); }
+  VW::finish(*vw);
+}
+
+static void bench_lda(benchmark::State& state, const std::string& cmd)
+{
+  // lda expects word counts as feature values
+  const auto examples = gen_text_examples(100, 1, 40, 1 << 12, no_labels(), false);
+  bench_single_line<true>(state, cmd, examples);
+}
+
+BENCHMARK_CAPTURE(bench_gd_learn, linear, "")->Apply(model_bits_args);
+BENCHMARK_CAPTURE(bench_gd_learn, quadratic, "-q ab")->Apply(model_bits_args);
+BENCHMARK_CAPTURE(bench_gd_learn, cubic, "--cubic abc")->Apply(model_bits_args);
+BENCHMARK_CAPTURE(bench_gd_predict, linear, "")->Apply(model_bits_args);
+BENCHMARK_CAPTURE(bench_gd_predict, quadratic, "-q ab")->Apply(model_bits_args);
+BENCHMARK_CAPTURE(bench_gd_predict, cubic, "--cubic abc")->Apply(model_bits_args);
+
+BENCHMARK_CAPTURE(bench_multiclass, oaa_1000, "--oaa 1000", multiclass_labels(1000));
+BENCHMARK_CAPTURE(bench_multiclass, oaa_1000_subsample, "--oaa 1000 --oaa_subsample 32", multiclass_labels(1000));
+BENCHMARK_CAPTURE(bench_multiclass, csoaa_1000, "--csoaa 1000", cost_sensitive_labels(1000, 5));
+BENCHMARK_CAPTURE(bench_multiclass, ect_1000, "--ect 1000", multiclass_labels(1000));
+BENCHMARK_CAPTURE(bench_multiclass, plt_100000, "--plt 100000 -b 24", multilabel_labels(100000, 3));
+BENCHMARK_CAPTURE(bench_multiclass_predict, oaa_1000, "--oaa 1000", multiclass_labels(1000));
+BENCHMARK_CAPTURE(bench_multiclass_predict, ect_1000, "--ect 1000", multiclass_labels(1000));
+BENCHMARK_CAPTURE(bench_multiclass_predict, plt_100000_top_5, "--plt 100000 -b 24 -t --top_k 5",
+    multilabel_labels(100000, 3));
+
+BENCHMARK_CAPTURE(bench_cb_explore_adf, epsilon, "--epsilon 0.1");
+BENCHMARK_CAPTURE(bench_cb_explore_adf, first, "--first 2");
+BENCHMARK_CAPTURE(bench_cb_explore_adf, bag, "--bag 5");
+BENCHMARK_CAPTURE(bench_cb_explore_adf, cover, "--cover 3");
+BENCHMARK_CAPTURE(bench_cb_explore_adf, softmax, "--softmax --lambda 10");
+BENCHMARK_CAPTURE(bench_cb_explore_adf, regcb, "--regcb");
+BENCHMARK_CAPTURE(bench_cb_explore_adf, regcbopt, "--regcbopt");
+BENCHMARK_CAPTURE(bench_cb_explore_adf, squarecb, "--squarecb");
+BENCHMARK_CAPTURE(bench_cb_explore_adf, squarecb_elim, "--squarecb --elim");
+BENCHMARK_CAPTURE(bench_cb_explore_adf, rnd, "--rnd 3");
+BENCHMARK_CAPTURE(bench_cb_explore_adf, synthcover, "--synthcover");
+
+BENCHMARK_CAPTURE(bench_lda, lda_10, "--lda 10 --lda_D 100 --minibatch 16");
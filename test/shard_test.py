@@ -0,0 +1,123 @@
+import sys
+import argparse
+import os
+import re
+import subprocess
+
+TOTAL = 3
+
+
+def run_vw(vw, args):
+    cmd_args = [vw] + args
+    print("Running VW with args: " + " ".join(cmd_args[1:]))
+    result = subprocess.run(cmd_args, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    if result.returncode != 0:
+        print("VW failed:")
+        print("STDOUT: \n" + result.stdout.decode("utf-8"))
+        print("STDERR: \n" + result.stderr.decode("utf-8"))
+        sys.exit(1)
+    return result.stderr.decode("utf-8")
+
+
+def number_of_examples(stderr):
+    match = re.search(r"number of examples = (\d+)", stderr)
+    if match is None:
+        print("No example count in output:\n" + stderr)
+        sys.exit(1)
+    return int(match.group(1))
+
+
+def shard_args(shard_by, node):
+    return [
+        "--shard_by",
+        shard_by,
+        "--total",
+        str(TOTAL),
+        "--node",
+        str(node),
+        "--unique_id",
+        "1234",
+    ]
+
+
+def check_tagged(vw, data_file, shard_by):
+    # Every example carries its line number as tag, which is written to the predictions.
+    tagged_file = "shard_test_tagged.dat"
+    with open(data_file) as f_in, open(tagged_file, "w") as f_out:
+        for index, line in enumerate(f_in):
+            label, rest = line.split("|", 1)
+            f_out.write("{} 'ex{}|{}".format(label.strip(), index, rest))
+    num_lines = index + 1
+
+    seen = []
+    for node in range(TOTAL):
+        prediction_file = "shard_test_{}.pred".format(node)
+        run_vw(
+            vw,
+            ["-d", tagged_file, "-t", "-p", prediction_file]
+            + shard_args(shard_by, node),
+        )
+        with open(prediction_file) as f:
+            tags = [line.split()[1] for line in f if line.strip()]
+        if not tags:
+            print("Node {} read no examples with --shard_by {}".format(node, shard_by))
+            sys.exit(1)
+        seen.extend(tags)
+
+    if sorted(seen) != sorted("ex{}".format(i) for i in range(num_lines)):
+        print("The shards of --shard_by {} do not partition the data".format(shard_by))
+        sys.exit(1)
+
+
+def check_counts(vw, data_file, shard_by, extra_args):
+    expected = number_of_examples(run_vw(vw, ["-d", data_file] + extra_args))
+    total = 0
+    for node in range(TOTAL):
+        total += number_of_examples(
+            run_vw(vw, ["-d", data_file] + extra_args + shard_args(shard_by, node))
+        )
+    if total != expected:
+        print(
+            "--shard_by {} with {} read {} examples instead of {}".format(
+                shard_by, " ".join(extra_args), total, expected
+            )
+        )
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--vw", help="Path to VW binary to use", type=str, required=True
+    )
+    parser.add_argument(
+        "--data_file",
+        help="Single line examples, each node reads its shard",
+        type=str,
+        required=True,
+    )
+    parser.add_argument(
+        "--multiline_data_file",
+        help="Examples separated by empty lines, read with --cb_adf",
+        type=str,
+        required=True,
+    )
+    args = parser.parse_args()
+
+    for shard_by in ["range", "hash"]:
+        check_tagged(args.vw, args.data_file, shard_by)
+        check_counts(args.vw, args.multiline_data_file, shard_by, ["--cb_adf"])
+        # The first pass writes the cache of the shard, the second one reads it.
+        check_counts(
+            args.vw,
+            args.data_file,
+            shard_by,
+            ["-c", "-k", "--passes", "2", "--holdout_off"],
+        )
+        for node in range(TOTAL):
+            cache_file = "{}.shard{}of{}.cache".format(args.data_file, node, TOTAL)
+            if not os.path.exists(cache_file):
+                print("Missing cache file " + cache_file)
+                sys.exit(1)
+            os.remove(cache_file)
+        os.remove(args.data_file + ".cache")
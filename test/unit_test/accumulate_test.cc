@@ -0,0 +1,193 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "accumulate.h"
+#include "allreduce.h"
+#include "global_data.h"
+#include "vw.h"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Runs body(all, node) on num_nodes workspaces which sync through AllReduceThreads, one thread per node. Boost checks
+// are not thread safe, so body should only record what the test checks afterwards.
+template <class F>
+void run_thread_nodes(size_t num_nodes, F body, const std::string& args = "--quiet -b 6")
+{
+  std::vector<VW::workspace*> nodes;
+  for (size_t i = 0; i < num_nodes; i++) { nodes.push_back(VW::initialize(args)); }
+  auto* root = new AllReduceThreads(num_nodes, 0, true);
+  for (size_t i = 0; i < num_nodes; i++)
+  {
+    nodes[i]->all_reduce_type = AllReduceType::Thread;
+    nodes[i]->all_reduce = i == 0 ? root : new AllReduceThreads(root, num_nodes, i, true);
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_nodes; i++)
+  {
+    threads.emplace_back([&nodes, &body, i] { body(*nodes[i], i); });
+  }
+  for (auto& thread : threads) { thread.join(); }
+
+  // the root owns the synchronization state of the other nodes
+  for (size_t i = num_nodes; i-- > 0;) { VW::finish(*nodes[i]); }
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(accumulate_bf16_round_trip)
+{
+  // values with at most 8 significant bits are exact
+  for (const float value : {0.f, 1.f, -2.5f, 0.15625f, std::ldexp(3.f, 60), -std::ldexp(1.f, -100)})
+  { BOOST_CHECK_EQUAL(VW::details::from_bf16(VW::details::to_bf16(value)), value); }
+
+  // round to nearest even: 1 + 2^-8 is halfway between 1 and 1 + 2^-7
+  BOOST_CHECK_EQUAL(VW::details::from_bf16(VW::details::to_bf16(1.f + std::ldexp(1.f, -8))), 1.f);
+  BOOST_CHECK_EQUAL(VW::details::from_bf16(VW::details::to_bf16(1.f + 3.f * std::ldexp(1.f, -8))),
+      1.f + std::ldexp(1.f, -6));
+
+  for (int i = -1000; i < 1000; i++)
+  {
+    const float value = static_cast<float>(i) * 0.37f + 0.001f;
+    const float decoded = VW::details::from_bf16(VW::details::to_bf16(value));
+    BOOST_CHECK_LE(std::fabs(decoded - value), std::fabs(value) * std::ldexp(1.f, -8));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(accumulate_int8_round_trip)
+{
+  const float scale = 2.f / 127.f;
+  for (int i = -200; i <= 200; i++)
+  {
+    const float value = static_cast<float>(i) / 100.f;
+    const float decoded = VW::details::from_int8(VW::details::to_int8(value, scale), scale);
+    BOOST_CHECK_LE(std::fabs(decoded - value), scale / 2.f + 1e-6f);
+  }
+
+  // values beyond 127 steps saturate
+  BOOST_CHECK_EQUAL(VW::details::to_int8(10.f, scale), 127);
+  BOOST_CHECK_EQUAL(VW::details::to_int8(-10.f, scale), -127);
+}
+
+BOOST_AUTO_TEST_CASE(accumulate_sparse_all_reduce_gathers_nonzeros)
+{
+  constexpr size_t num_nodes = 3;
+  constexpr uint64_t length = 64;
+
+  // Node n has nonzeros at 3n + 1 and at 40, which all nodes share.
+  auto local_values = [](size_t node) {
+    std::vector<float> values(length, 0.f);
+    values[3 * node + 1] = static_cast<float>(node + 1);
+    values[40] = -static_cast<float>(node + 1);
+    return values;
+  };
+  std::vector<float> expected(length, 0.f);
+  for (size_t node = 0; node < num_nodes; node++)
+  {
+    const auto values = local_values(node);
+    for (uint64_t i = 0; i < length; i++) { expected[i] += values[i]; }
+  }
+
+  for (const auto quantization :
+      {AllReduceQuantization::Float32, AllReduceQuantization::BFloat16, AllReduceQuantization::Int8})
+  {
+    std::vector<std::vector<float>> results(num_nodes);
+    std::vector<size_t> residual_sizes(num_nodes);
+    run_thread_nodes(num_nodes, [&](VW::workspace& all, size_t node) {
+      all.all_reduce->sparse_density = 0.5f;
+      all.all_reduce->quantization = quantization;
+      results[node] = local_values(node);
+      VW::details::all_reduce_values(all, results[node].data(), length, 7);
+      residual_sizes[node] = all.all_reduce->residuals.size();
+    });
+
+    for (size_t node = 0; node < num_nodes; node++)
+    {
+      // every value in this test is a whole number of quantization steps
+      for (uint64_t i = 0; i < length; i++) { BOOST_CHECK_CLOSE(results[node][i], expected[i], 1e-4f); }
+      BOOST_CHECK_EQUAL(residual_sizes[node], quantization == AllReduceQuantization::Float32 ? 0 : 1);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(accumulate_quantized_residual_is_fed_back)
+{
+  constexpr size_t num_nodes = 2;
+  constexpr size_t num_syncs = 4;
+  constexpr uint64_t length = 16;
+  const float value = 1.f + std::ldexp(1.f, -9);  // rounds down to 1 in bf16
+
+  std::vector<std::vector<float>> sums(num_nodes, std::vector<float>(length, 0.f));
+  std::vector<std::vector<float>> first(num_nodes);
+  run_thread_nodes(num_nodes, [&](VW::workspace& all, size_t node) {
+    all.all_reduce->quantization = AllReduceQuantization::BFloat16;
+    std::vector<float> values;
+    for (size_t sync = 0; sync < num_syncs; sync++)
+    {
+      values.assign(length, value);
+      VW::details::all_reduce_values(all, values.data(), length, 3);
+      if (sync == 0) { first[node] = values; }
+      for (uint64_t i = 0; i < length; i++) { sums[node][i] += values[i]; }
+    }
+  });
+
+  // Without error feedback every sync would return 2 and lose the 2^-9 of each node.
+  const float exact = static_cast<float>(num_syncs * num_nodes) * value;
+  for (size_t node = 0; node < num_nodes; node++)
+  {
+    for (uint64_t i = 0; i < length; i++)
+    {
+      BOOST_CHECK_EQUAL(first[node][i], 2.f);
+      BOOST_CHECK_EQUAL(sums[node][i], exact);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(accumulate_weighted_avg_over_several_chunks)
+{
+  constexpr size_t num_nodes = 3;
+  // -b 20 below syncs 4 chunks of ar_strided_chunk_size weights.
+  // Parameter i of node n has weight n + 1 and adaptive accumulator i % 5 + n + 1.
+  auto accumulator = [](uint64_t i, size_t node) { return static_cast<float>(i % 5 + node + 1); };
+
+  std::vector<size_t> mismatches(num_nodes, 0);
+  run_thread_nodes(
+      num_nodes,
+      [&](VW::workspace& all, size_t node) {
+        auto& dense = all.weights.dense_weights;
+        const uint64_t num_weights = static_cast<uint64_t>(1) << all.num_bits;
+        for (uint64_t i = 0; i < num_weights; i++)
+        {
+          dense.first()[i << dense.stride_shift()] = static_cast<float>(node + 1);
+          dense.first()[(i << dense.stride_shift()) + 1] = accumulator(i, node);
+        }
+
+        accumulate_weighted_avg(all, all.weights);
+
+        // The weights are averaged with the accumulators as weights.
+        for (uint64_t i = 0; i < num_weights; i++)
+        {
+          float weighted = 0.f;
+          float total = 0.f;
+          for (size_t n = 0; n < num_nodes; n++)
+          {
+            weighted += static_cast<float>(n + 1) * accumulator(i, n);
+            total += accumulator(i, n);
+          }
+          const float expected = weighted / total;
+          const float actual = dense.first()[i << dense.stride_shift()];
+          if (std::fabs(actual - expected) > 1e-5f * expected) { mismatches[node]++; }
+        }
+      },
+      "--quiet -b 20");
+
+  for (size_t node = 0; node < num_nodes; node++) { BOOST_CHECK_EQUAL(mismatches[node], 0); }
+}
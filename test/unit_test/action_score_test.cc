@@ -0,0 +1,73 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "action_score.h"
+#include "vw.h"
+#include "vw_exception.h"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(sort_top_k_matches_prefix_of_full_sort)
+{
+  std::vector<ACTION_SCORE::action_score> all_scores;
+  for (uint32_t i = 0; i < 1000; ++i) { all_scores.push_back({i, static_cast<float>((i * 7919) % 97)}); }
+
+  auto sorted = all_scores;
+  std::sort(sorted.begin(), sorted.end(), VW::action_score_compare_lt);
+
+  for (const size_t k : {size_t(1), size_t(2), size_t(10), size_t(999), size_t(1000), size_t(5000)})
+  {
+    auto top = all_scores;
+    VW::sort_top_k(top.begin(), top.end(), k, VW::action_score_compare_lt);
+
+    const size_t prefix = (std::min)(k, top.size());
+    for (size_t i = 0; i < prefix; ++i)
+    {
+      BOOST_CHECK_EQUAL(top[i].action, sorted[i].action);
+      BOOST_CHECK_EQUAL(top[i].score, sorted[i].score);
+    }
+
+    // every action is still in the prediction
+    std::sort(top.begin(), top.end(), VW::action_score_compare_lt);
+    for (size_t i = 0; i < top.size(); ++i) { BOOST_CHECK_EQUAL(top[i].action, sorted[i].action); }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sort_top_k_zero_leaves_range)
+{
+  std::vector<ACTION_SCORE::action_score> scores = {{0, 3.f}, {1, 1.f}, {2, 2.f}};
+  VW::sort_top_k(scores.begin(), scores.end(), 0, VW::action_score_compare_lt);
+  BOOST_CHECK_EQUAL(scores[0].action, 0);
+  BOOST_CHECK_EQUAL(scores[1].action, 1);
+  BOOST_CHECK_EQUAL(scores[2].action, 2);
+
+  std::vector<ACTION_SCORE::action_score> empty;
+  VW::sort_top_k(empty.begin(), empty.end(), 3, VW::action_score_compare_lt);
+  BOOST_CHECK(empty.empty());
+}
+
+BOOST_AUTO_TEST_CASE(rank_top_k_only_applies_to_final_ranking)
+{
+  for (const auto* args :
+      {"--csoaa_ldf m --csoaa_rank --rank_top_k 2 --quiet", "--cb_adf --rank_all --rank_top_k 2 --quiet"})
+  {
+    auto* vw = VW::initialize(args);
+    VW::finish(*vw);
+  }
+
+  for (const auto* args : {"--csoaa_ldf m --rank_top_k 2 --quiet", "--cb_adf --rank_top_k 2 --quiet",
+           "--cb_explore_adf --rank_top_k 2 --quiet", "--cb_explore_adf --bag 3 --rank_all --rank_top_k 2 --quiet",
+           "--cb_explore_adf --cover 3 --rank_top_k 2 --quiet"})
+  {
+    BOOST_CHECK_THROW(VW::initialize(args), VW::vw_exception);
+  }
+
+  // 0 keeps the full ranking, so it is accepted everywhere
+  auto* vw = VW::initialize("--cb_explore_adf --rank_top_k 0 --quiet");
+  VW::finish(*vw);
+}
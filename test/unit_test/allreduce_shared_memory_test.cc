@@ -0,0 +1,126 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#ifndef _WIN32
+#  include "allreduce.h"
+#  include "io/logger.h"
+#  include "spanning_tree.h"
+
+#  include <boost/test/test_tools.hpp>
+#  include <boost/test/unit_test.hpp>
+
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+
+#  include <memory>
+#  include <string>
+#  include <thread>
+#  include <vector>
+
+namespace
+{
+void add_float(float& a, const float& b) { a += b; }
+
+// Threads of this process stand in for the processes of a host, they map the segment just like processes would.
+std::string segment_name(size_t host)
+{
+  return "/vw_allreduce_test_" + std::to_string(getpid()) + "_" + std::to_string(host);
+}
+
+// Node k contributes (k + 1) * (i % 5) at position i of component 1 of a stride-2 buffer, which spans two and a bit
+// shared memory slots. Every node syncs twice, so the result slots alternate across calls as well.
+void check_sum_over_nodes(std::vector<std::unique_ptr<AllReduceSharedMemory>>& nodes)
+{
+  constexpr size_t stride = 2;
+  const size_t n = 2 * ar_shm_slot_size / sizeof(float) + 7;
+  const size_t total = nodes.size();
+  std::vector<std::vector<float>> buffers(total, std::vector<float>(n * stride));
+  std::vector<std::string> errors(total);
+
+  std::vector<std::thread> threads;
+  for (size_t node = 0; node < total; node++)
+  {
+    threads.emplace_back([&, node] {
+      auto logger = VW::io::create_null_logger();
+      auto& buffer = buffers[node];
+      try
+      {
+        for (int sync = 0; sync < 2; sync++)
+        {
+          for (size_t i = 0; i < n * stride; i++) { buffer[i] = static_cast<float>((node + 1) * (i / stride % 5)); }
+          nodes[node]->all_reduce<float, add_float>(buffer.data() + 1, n, stride, logger);
+        }
+      }
+      catch (const std::exception& e)
+      {
+        errors[node] = e.what();
+      }
+    });
+  }
+  for (auto& thread : threads) { thread.join(); }
+
+  const float node_sum = static_cast<float>(total * (total + 1) / 2);
+  for (size_t node = 0; node < total; node++)
+  {
+    BOOST_REQUIRE_EQUAL(errors[node], "");
+    size_t mismatches = 0;
+    for (size_t i = 0; i < n * stride; i++)
+    {
+      const float factor = i % stride == 1 ? node_sum : static_cast<float>(node + 1);
+      if (buffers[node][i] != factor * static_cast<float>(i / stride % 5)) { mismatches++; }
+    }
+    BOOST_CHECK_EQUAL(mismatches, 0);
+  }
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(allreduce_shared_memory_sums_over_processes_of_one_host)
+{
+  constexpr size_t total = 3;
+  std::vector<std::unique_ptr<AllReduceSharedMemory>> nodes;
+  for (size_t node = 0; node < total; node++)
+  {
+    nodes.emplace_back(new AllReduceSharedMemory(segment_name(0), total, node, nullptr, total, node, true));
+  }
+  check_sum_over_nodes(nodes);
+}
+
+BOOST_AUTO_TEST_CASE(allreduce_shared_memory_sums_over_hosts)
+{
+  VW::SpanningTree server(0, true);
+  server.Start();
+
+  constexpr size_t hosts = 2;
+  constexpr size_t nodes_per_host = 2;
+  std::vector<std::unique_ptr<AllReduceSharedMemory>> nodes;
+  for (size_t node = 0; node < hosts * nodes_per_host; node++)
+  {
+    const size_t host = node / nodes_per_host;
+    const size_t local_node = node % nodes_per_host;
+    std::unique_ptr<AllReduceSockets> host_connection;
+    if (local_node == 0)
+    { host_connection.reset(new AllReduceSockets("localhost", server.BoundPort(), 11, hosts, host, true)); }
+    nodes.emplace_back(new AllReduceSharedMemory(segment_name(host), nodes_per_host, local_node,
+        std::move(host_connection), hosts * nodes_per_host, node, true));
+  }
+  check_sum_over_nodes(nodes);
+}
+
+BOOST_AUTO_TEST_CASE(allreduce_shared_memory_last_process_removes_segment)
+{
+  const std::string name = segment_name(7);
+  {
+    AllReduceSharedMemory first(name, 2, 0, nullptr, 2, 0, true);
+    AllReduceSharedMemory second(name, 2, 1, nullptr, 2, 1, true);
+  }
+  const int fd = shm_open(name.c_str(), O_RDWR, 0);
+  BOOST_CHECK_EQUAL(fd, -1);
+  if (fd != -1)
+  {
+    close(fd);
+    shm_unlink(name.c_str());
+  }
+}
+#endif
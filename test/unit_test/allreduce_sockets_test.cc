@@ -0,0 +1,235 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "allreduce.h"
+#include "io/logger.h"
+#include "spanning_tree.h"
+#include "vw_exception.h"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+constexpr size_t unique_id = 7;
+constexpr size_t length = 8;
+
+void add_float(float& a, const float& b) { a += b; }
+
+std::unique_ptr<AllReduceSockets> make_node(
+    VW::SpanningTree& server, size_t node, size_t total = 2, AllReduceAlgorithm algorithm = AllReduceAlgorithm::Tree)
+{
+  auto sockets = std::unique_ptr<AllReduceSockets>(
+      new AllReduceSockets("localhost", server.BoundPort(), unique_id, total, node, true, algorithm));
+  // The timeout only bounds the test if a failure goes unnoticed, closed connections fail the sync right away.
+  sockets->timeout_seconds = 30.f;
+  sockets->max_retries = 2;
+  return sockets;
+}
+
+// Result of one all_reduce on a separate thread. Boost checks are not thread safe, so the thread only records it.
+struct sync_result
+{
+  std::vector<float> values;
+  std::string error;
+  bool rejoin_failed = false;
+};
+
+std::thread start_sync(AllReduceSockets& node, std::vector<float> values, sync_result& result)
+{
+  return std::thread([&node, values, &result]() mutable {
+    auto logger = VW::io::create_null_logger();
+    try
+    {
+      node.all_reduce<float, add_float>(values.data(), values.size(), logger);
+      result.values = values;
+    }
+    catch (const VW::allreduce_rejoin_exception& e)
+    {
+      result.rejoin_failed = true;
+      result.error = e.what();
+    }
+    catch (const std::exception& e)
+    {
+      result.error = e.what();
+    }
+  });
+}
+
+// Every node syncs values[node] at the same time.
+std::vector<sync_result> sync_all(
+    std::vector<std::unique_ptr<AllReduceSockets>>& nodes, const std::vector<std::vector<float>>& values)
+{
+  std::vector<sync_result> results(nodes.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < nodes.size(); i++) { threads.push_back(start_sync(*nodes[i], values[i], results[i])); }
+  for (auto& thread : threads) { thread.join(); }
+  return results;
+}
+
+// Node k contributes k + 1 + i % 3 at position i. Large enough to take the ring or halving path, and not a multiple
+// of the number of nodes so that the chunks differ in size.
+void check_sum_over_nodes(AllReduceAlgorithm algorithm, size_t total)
+{
+  VW::SpanningTree server(0, true);
+  server.Start();
+
+  const size_t n = ar_buf_size + 3;
+  std::vector<std::unique_ptr<AllReduceSockets>> nodes;
+  std::vector<std::vector<float>> values;
+  for (size_t node = 0; node < total; node++)
+  {
+    nodes.push_back(make_node(server, node, total, algorithm));
+    values.emplace_back(n);
+    for (size_t i = 0; i < n; i++) { values[node][i] = static_cast<float>(node + 1 + i % 3); }
+  }
+
+  const auto results = sync_all(nodes, values);
+  const float node_sum = static_cast<float>(total * (total + 1) / 2);
+  for (const auto& result : results)
+  {
+    BOOST_REQUIRE_EQUAL(result.error, "");
+    BOOST_REQUIRE_EQUAL(result.values.size(), n);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+      if (result.values[i] != node_sum + static_cast<float>(total * (i % 3))) { mismatches++; }
+    }
+    BOOST_CHECK_EQUAL(mismatches, 0);
+  }
+}
+
+// Both nodes complete one sync, then node 1 dies and node 0 starts the next sync.
+std::unique_ptr<AllReduceSockets> sync_then_fail_node_1(
+    VW::SpanningTree& server, sync_result& survivor_result, std::thread& survivor)
+{
+  auto node_0 = make_node(server, 0);
+  auto node_1 = make_node(server, 1);
+  sync_result first_0;
+  sync_result first_1;
+  auto thread_0 = start_sync(*node_0, std::vector<float>(length, 1.f), first_0);
+  auto thread_1 = start_sync(*node_1, std::vector<float>(length, 2.f), first_1);
+  thread_0.join();
+  thread_1.join();
+  BOOST_REQUIRE_EQUAL(first_0.error, "");
+  BOOST_REQUIRE_EQUAL(first_1.error, "");
+  for (const float value : first_0.values) { BOOST_CHECK_EQUAL(value, 3.f); }
+
+  survivor = start_sync(*node_0, std::vector<float>(length, 10.f), survivor_result);
+  node_1.reset();
+  return node_0;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(allreduce_sockets_replacement_node_joins_rebuilt_tree)
+{
+  VW::SpanningTree server(0, true);
+  server.Start();
+
+  sync_result survivor_result;
+  std::thread survivor;
+  auto node_0 = sync_then_fail_node_1(server, survivor_result, survivor);
+
+  // The replacement starts from the last synced model and makes its first call.
+  auto replacement = make_node(server, 1);
+  sync_result replacement_result;
+  auto thread_1 = start_sync(*replacement, std::vector<float>(length, 20.f), replacement_result);
+  survivor.join();
+  thread_1.join();
+
+  BOOST_REQUIRE_EQUAL(survivor_result.error, "");
+  BOOST_REQUIRE_EQUAL(replacement_result.error, "");
+  for (size_t i = 0; i < length; i++)
+  {
+    BOOST_CHECK_EQUAL(survivor_result.values[i], 30.f);
+    BOOST_CHECK_EQUAL(replacement_result.values[i], 30.f);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(allreduce_sockets_rejoin_with_other_buffer_size_fails)
+{
+  VW::SpanningTree server(0, true);
+  server.Start();
+
+  sync_result survivor_result;
+  std::thread survivor;
+  auto node_0 = sync_then_fail_node_1(server, survivor_result, survivor);
+
+  // A replacement that syncs a different number of values must not be mixed into the survivor's sync.
+  auto replacement = make_node(server, 1);
+  sync_result replacement_result;
+  auto thread_1 = start_sync(*replacement, std::vector<float>(length + 1, 20.f), replacement_result);
+  survivor.join();
+  thread_1.join();
+
+  BOOST_CHECK(survivor_result.rejoin_failed);
+  BOOST_CHECK(replacement_result.rejoin_failed);
+}
+
+BOOST_AUTO_TEST_CASE(allreduce_sockets_ring_sums_over_all_nodes)
+{
+  check_sum_over_nodes(AllReduceAlgorithm::Ring, 3);
+  check_sum_over_nodes(AllReduceAlgorithm::Ring, 4);
+}
+
+BOOST_AUTO_TEST_CASE(allreduce_sockets_recursive_halving_sums_over_all_nodes)
+{
+  check_sum_over_nodes(AllReduceAlgorithm::RecursiveHalving, 2);
+  check_sum_over_nodes(AllReduceAlgorithm::RecursiveHalving, 4);
+}
+
+BOOST_AUTO_TEST_CASE(allreduce_sockets_strided_reduces_only_its_component)
+{
+  VW::SpanningTree server(0, true);
+  server.Start();
+
+  // More than one staging chunk, and the last one partial.
+  constexpr size_t stride = 4;
+  const size_t n = ar_strided_chunk_size + 5;
+  std::vector<std::unique_ptr<AllReduceSockets>> nodes;
+  std::vector<std::vector<float>> buffers;
+  for (size_t node = 0; node < 2; node++)
+  {
+    nodes.push_back(make_node(server, node));
+    buffers.emplace_back(n * stride);
+    for (size_t i = 0; i < n * stride; i++) { buffers[node][i] = static_cast<float>((node + 1) * (i % 7)); }
+  }
+
+  std::vector<std::string> errors(nodes.size());
+  std::vector<std::thread> threads;
+  for (size_t node = 0; node < nodes.size(); node++)
+  {
+    threads.emplace_back([&, node] {
+      auto logger = VW::io::create_null_logger();
+      try
+      {
+        nodes[node]->all_reduce<float, add_float>(buffers[node].data() + 1, n, stride, logger);
+      }
+      catch (const std::exception& e)
+      {
+        errors[node] = e.what();
+      }
+    });
+  }
+  for (auto& thread : threads) { thread.join(); }
+
+  for (size_t node = 0; node < nodes.size(); node++)
+  {
+    BOOST_REQUIRE_EQUAL(errors[node], "");
+    // Component 1 holds the sum of both nodes, the other components keep the local values.
+    size_t mismatches = 0;
+    for (size_t i = 0; i < n * stride; i++)
+    {
+      const float local = static_cast<float>((node + 1) * (i % 7));
+      const float expected = i % stride == 1 ? 3.f * static_cast<float>(i % 7) : local;
+      if (buffers[node][i] != expected) { mismatches++; }
+    }
+    BOOST_CHECK_EQUAL(mismatches, 0);
+  }
+}
@@ -0,0 +1,86 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "async_averager.h"
+
+#include "allreduce.h"
+#include "global_data.h"
+#include "spanning_tree.h"
+#include "vw.h"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+std::unique_ptr<AllReduceSockets> make_connection(VW::SpanningTree& server, size_t total, size_t node)
+{
+  return std::unique_ptr<AllReduceSockets>(
+      new AllReduceSockets("localhost", server.BoundPort(), 11, total, node, true));
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(async_averager_end_pass_averages_the_change_of_all_nodes)
+{
+  VW::SpanningTree server(0, true);
+  server.Start();
+
+  constexpr size_t num_nodes = 2;
+  std::vector<VW::workspace*> nodes;
+  std::vector<std::unique_ptr<VW::async_averager>> averagers;
+  for (size_t node = 0; node < num_nodes; node++)
+  {
+    nodes.push_back(VW::initialize("--quiet -b 4"));
+    // No rounds while learning, end_pass averages everything.
+    averagers.emplace_back(new VW::async_averager(*nodes[node], make_connection(server, num_nodes, node), 0, 0.f, 1.f));
+    // Takes the initial weights as the reference all nodes agree on.
+    averagers[node]->on_example();
+  }
+
+  const size_t length = static_cast<size_t>(1) << nodes[0]->num_bits;
+  for (size_t node = 0; node < num_nodes; node++)
+  {
+    auto& weights = nodes[node]->weights.dense_weights;
+    for (size_t i = 0; i < length; i++) { weights.strided_index(i) = static_cast<float>((node + 1) * i); }
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t node = 0; node < num_nodes; node++)
+  {
+    threads.emplace_back([&averagers, node] { averagers[node]->end_pass(); });
+  }
+  for (auto& thread : threads) { thread.join(); }
+
+  for (size_t node = 0; node < num_nodes; node++)
+  {
+    auto& weights = nodes[node]->weights.dense_weights;
+    for (size_t i = 0; i < length; i++) { BOOST_CHECK_CLOSE(weights.strided_index(i), 1.5f * i, 1e-4f); }
+  }
+
+  averagers.clear();
+  for (auto* node : nodes) { VW::finish(*node); }
+}
+
+BOOST_AUTO_TEST_CASE(async_averager_destructor_gives_up_on_missing_node)
+{
+  VW::SpanningTree server(0, true);
+  server.Start();
+
+  // Node 1 never connects, so the first round can not finish.
+  auto* all = VW::initialize("--quiet -b 4");
+  const auto start = std::chrono::steady_clock::now();
+  {
+    VW::async_averager averager(*all, make_connection(server, 2, 0), 1, 0.f, 1.f);
+    averager.shutdown_timeout = std::chrono::milliseconds(200);
+    // The first example already starts a round with an interval of one example.
+    averager.on_example();
+  }
+  BOOST_CHECK_LT(std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count(), 10.f);
+  VW::finish(*all);
+}
@@ -265,6 +265,15 @@ BOOST_AUTO_TEST_CASE(namespace_switch)
     size_t tser_count = aml->cm->ns_counter.at('T');
     BOOST_CHECK_GT(tser_count, 1);
 
+    // the interactions of 'T' were inserted into the live configs, they must match a full regeneration
+    aml_test::check_interactions_match_exclusions(aml);
+    for (uint64_t live_slot = 0; live_slot < aml->cm->scores.size(); ++live_slot)
+    {
+      auto inserted = aml->cm->scores[live_slot].live_interactions;
+      aml->cm->gen_quadratic_interactions(live_slot);
+      BOOST_CHECK(inserted == aml->cm->scores[live_slot].live_interactions);
+    }
+
     // reset user namespace to appropriate value
     sim.user_ns = "User";
     return true;
@@ -378,4 +387,27 @@ BOOST_AUTO_TEST_CASE(clear_configs_one_diff)
       num_iterations, seed);
 
   BOOST_CHECK_GT(ctr.back(), 0.4f);
-}
\ No newline at end of file
+}
+BOOST_AUTO_TEST_CASE(automl_threads)
+{
+  const size_t num_iterations = 1331;
+  const size_t check_point = 500;
+  callback_map test_hooks;
+
+  test_hooks.emplace(check_point, [&check_point](cb_sim&, VW::workspace& all, VW::multi_ex&) {
+    VW::automl::automl<interaction_config_manager>* aml = aml_test::get_automl_data(all);
+    aml_test::check_interactions_match_exclusions(aml);
+    aml_test::check_config_states(aml);
+    BOOST_CHECK(aml->workers != nullptr);
+    BOOST_CHECK_EQUAL(check_point, aml->cm->total_learn_count);
+    return true;
+  });
+
+  // the main thread learns the live slots 0 and 3, the two workers the slots 1 and 2
+  auto ctr = simulator::_test_helper_hook(
+      "--automl 4 --priority_type least_exclusion --cb_explore_adf --quiet --epsilon 0.2 --random_seed 5 "
+      "--automl_threads 3",
+      test_hooks, num_iterations);
+
+  BOOST_CHECK_GT(ctr.back(), 0.7f);
+}
@@ -483,6 +483,35 @@ BOOST_AUTO_TEST_CASE(offset_tree_cont_predict)
   VW::cats_tree::predict_test_helper({1, 1}, 6, 8, 2);
 }
 
+BOOST_AUTO_TEST_CASE(offset_tree_cont_predict_is_logarithmic)
+{
+  // a min depth tree over 65536 leaves has depth 16, predict asks the base once per level
+  reduction_test_harness* pharness = nullptr;
+  auto* base = get_test_harness_reduction(predictions_t(32, 1.f), pharness);
+  cats_tree tree;
+  tree.init(65536, 0);
+  example ec;
+  BOOST_CHECK_EQUAL(tree.predict(*as_singleline(base), ec), 65536);
+  BOOST_CHECK_EQUAL(pharness->_curr_idx, 16);
+  delete base;
+}
+
+BOOST_AUTO_TEST_CASE(cats_pdf_predict_pdf_size_does_not_depend_on_num_actions)
+{
+  auto& vw = *VW::initialize("--cats_pdf 65536 --bandwidth 10 --min_value 0 --max_value 65536 --quiet");
+  auto* ec = VW::read_example(vw, "| f:1");
+  vw.predict(*ec);
+
+  // the pmf is the predicted leaf only, so the pdf is the smoothed leaf and at most the two ranges around it
+  BOOST_CHECK_LE(ec->pred.pdf.size(), 3);
+  float mass = 0.f;
+  for (const auto& segment : ec->pred.pdf) { mass += (segment.right - segment.left) * segment.pdf_value; }
+  BOOST_CHECK_CLOSE(mass, 1.f, 0.01f);
+
+  VW::finish_example(vw, *ec);
+  VW::finish(vw);
+}
+
 BOOST_AUTO_TEST_CASE(build_min_depth_tree_cont_5)
 {
   VW::cats_tree::min_depth_binary_tree tree;
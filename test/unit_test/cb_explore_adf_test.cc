@@ -4,8 +4,13 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include "learner.h"
+#include "reductions/cb/cb_explore_adf_cost_ranges.h"
 #include "vw.h"
 
+#include <string>
+#include <vector>
+
 BOOST_AUTO_TEST_CASE(cb_explore_adf_should_throw_empty_multi_example) {
   auto vw = VW::initialize("--cb_explore_adf --quiet", nullptr, false, nullptr, nullptr);
   VW::multi_ex example_collection;
@@ -14,3 +19,100 @@ BOOST_AUTO_TEST_CASE(cb_explore_adf_should_throw_empty_multi_example) {
   BOOST_REQUIRE_THROW(vw->learn(example_collection), VW::vw_exception);
   VW::finish(*vw);
 }
+
+BOOST_AUTO_TEST_CASE(cb_explore_adf_multipredict_matches_predict)
+{
+  // dr does not implement multipredict in cb_adf, it checks the fallback of the learner
+  for (const std::string cb_type : {"mtr", "ips", "dr"})
+  {
+    auto& vw = *VW::initialize("--cb_explore_adf --bag 4 --quiet --random_seed 5 --cb_type " + cb_type);
+    for (int i = 0; i < 20; ++i)
+    {
+      VW::multi_ex examples;
+      examples.push_back(VW::read_example(vw, "shared | s_" + std::to_string(i % 3)));
+      for (int a = 0; a < 3; ++a)
+      {
+        const std::string label = a == i % 3 ? "0:" + std::to_string(-a) + ":0.5 " : "";
+        examples.push_back(VW::read_example(vw, label + "| a_" + std::to_string(a) + " b_" + std::to_string(i % 2)));
+      }
+      vw.learn(examples);
+      vw.finish_example(examples);
+    }
+
+    auto* cb_adf = VW::LEARNER::as_multiline(vw.l->get_learner_by_name_prefix("cb_adf"));
+    VW::multi_ex examples;
+    for (int a = 0; a < 3; ++a) { examples.push_back(VW::read_example(vw, "| a_" + std::to_string(a) + " b_1")); }
+
+    std::vector<VW::polyprediction> preds(4);
+    cb_adf->multipredict(examples, 0, 4, preds.data(), false);
+    for (size_t i = 0; i < 4; ++i)
+    {
+      cb_adf->predict(examples, i);
+      const auto& expected = examples[0]->pred.a_s;
+      BOOST_REQUIRE_EQUAL(preds[i].a_s.size(), expected.size());
+      for (size_t j = 0; j < expected.size(); ++j)
+      {
+        BOOST_CHECK_EQUAL(preds[i].a_s[j].action, expected[j].action);
+        BOOST_CHECK_CLOSE(preds[i].a_s[j].score, expected[j].score, 1e-3);
+      }
+    }
+    vw.finish_example(examples);
+    VW::finish(vw);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(cb_explore_adf_closed_form_weight_matches_binary_search)
+{
+  for (const float fhat : {1.f, 1.5f, 2.f, 3.f})
+  {
+    for (const float sens : {0.01f, 0.2f, 1.f, 5.f})
+    {
+      for (const float delta : {0.5f, 2.f, 10.f, 100.f})
+      {
+        const float w = VW::cb_explore_adf::closed_form_weight(fhat, delta, sens);
+        const float expected = VW::cb_explore_adf::binary_search(fhat, delta, sens);
+        BOOST_CHECK_SMALL(sens * (w - expected), 2e-5f);
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(VW::cb_explore_adf::closed_form_weight(2.f, 0.f, 1.f), 0.f);
+  BOOST_CHECK_EQUAL(VW::cb_explore_adf::closed_form_weight(2.f, 100.f, 1.f), 2.f);
+}
+
+BOOST_AUTO_TEST_CASE(cb_explore_adf_closed_form_cost_ranges_match_binary_search)
+{
+  auto& vw = *VW::initialize("--cb_explore_adf --squarecb --elim --quiet --random_seed 5");
+  for (int i = 0; i < 50; ++i)
+  {
+    VW::multi_ex examples;
+    examples.push_back(VW::read_example(vw, "shared | s_" + std::to_string(i % 3)));
+    for (int a = 0; a < 4; ++a)
+    {
+      const std::string label = a == i % 4 ? "0:" + std::to_string(a % 2) + ":0.25 " : "";
+      examples.push_back(VW::read_example(vw, label + "| a_" + std::to_string(a) + " b_" + std::to_string(i % 2)));
+    }
+    vw.learn(examples);
+    vw.finish_example(examples);
+  }
+
+  auto* cb_adf = VW::LEARNER::as_multiline(vw.l->get_learner_by_name_prefix("cb_adf"));
+  VW::multi_ex examples;
+  for (int a = 0; a < 4; ++a) { examples.push_back(VW::read_example(vw, "| a_" + std::to_string(a) + " b_1")); }
+  cb_adf->predict(examples);
+
+  VW::cb_explore_adf::cost_ranges bisection;
+  VW::cb_explore_adf::cost_ranges closed_form;
+  for (const float delta : {0.1f, 1.f, 10.f})
+  {
+    bisection.compute(delta, *cb_adf, examples, 0.f, 1.f, false);
+    closed_form.compute(delta, *cb_adf, examples, 0.f, 1.f, false, /*closed_form=*/true);
+    BOOST_REQUIRE_EQUAL(bisection.min_costs.size(), 4);
+    for (size_t a = 0; a < 4; ++a)
+    {
+      BOOST_CHECK_SMALL(closed_form.min_costs[a] - bisection.min_costs[a], 2e-5f);
+      BOOST_CHECK_SMALL(closed_form.max_costs[a] - bisection.max_costs[a], 2e-5f);
+    }
+  }
+  vw.finish_example(examples);
+  VW::finish(vw);
+}
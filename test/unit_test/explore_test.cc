@@ -7,6 +7,7 @@
 
 #include "test_common.h"
 
+#include <deque>
 #include <vector>
 #include "../../explore/explore.h"
 
@@ -177,4 +178,72 @@ BOOST_AUTO_TEST_CASE(swap_test)
 
   const std::vector<float> expected_pdf_2 = { 0.266666667f,	0.133333333f,	0.2f,	0.066666667f,	0.333333333f };
   check_collections_with_float_tolerance(pdf, expected_pdf_2, .0001f);
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE(softmax_contiguous_matches_iterator)
+{
+  // std::deque is random access but not contiguous, so it goes through the generic iterator loops.
+  std::vector<float> scores(1003);
+  for (size_t i = 0; i < scores.size(); ++i) { scores[i] = static_cast<float>((i * 7919) % 101) / 10.f - 5.f; }
+  const std::deque<float> deque_scores(scores.begin(), scores.end());
+
+  for (const float lambda : {0.5f, -1.f})
+  {
+    std::vector<float> pmf(scores.size());
+    std::deque<float> deque_pmf(scores.size());
+    BOOST_CHECK_EQUAL(exploration::generate_softmax(lambda, begin(scores), end(scores), begin(pmf), end(pmf)),
+        S_EXPLORATION_OK);
+    BOOST_CHECK_EQUAL(exploration::generate_softmax(lambda, deque_scores.begin(), deque_scores.end(),
+                          deque_pmf.begin(), deque_pmf.end()),
+        S_EXPLORATION_OK);
+    check_collections_with_float_tolerance(pmf, deque_pmf, .0001f);
+
+    // in place, as done on the action scores by the reductions
+    std::vector<float> in_place = scores;
+    exploration::generate_softmax(lambda, begin(in_place), end(in_place), begin(in_place), end(in_place));
+    check_collections_with_float_tolerance(in_place, deque_pmf, .0001f);
+  }
+
+  // fewer scores than pmf entries
+  const std::vector<float> short_scores = {1.f, 2.f, 3.f};
+  const std::vector<float> expected = {0.269307f, 0.328933f, 0.401760f, 0.f, 0.f};
+  std::vector<float> pmf(5, 1.f);
+  BOOST_CHECK_EQUAL(
+      exploration::generate_softmax(0.2f, short_scores.data(), short_scores.size(), pmf.data(), pmf.size()),
+      S_EXPLORATION_OK);
+  check_collections_with_float_tolerance(pmf, expected, .0001f);
+
+  float x;
+  std::vector<float> empty;
+  BOOST_CHECK_EQUAL(
+      exploration::generate_softmax(0.2f, begin(empty), end(empty), begin(empty), end(empty)), E_EXPLORATION_BAD_RANGE);
+  BOOST_CHECK_EQUAL(
+      exploration::generate_softmax(0.2f, begin(scores), end(scores), &x, &x - 3), E_EXPLORATION_BAD_RANGE);
+}
+
+BOOST_AUTO_TEST_CASE(sample_after_normalizing_contiguous_matches_iterator)
+{
+  std::vector<float> weights(1003);
+  for (size_t i = 0; i < weights.size(); ++i) { weights[i] = (i % 3 == 0) ? 0.f : static_cast<float>(i % 17); }
+  weights[5] = -1.f;
+
+  for (uint64_t seed = 1; seed < 100; ++seed)
+  {
+    std::vector<float> pmf = weights;
+    std::deque<float> deque_pmf(weights.begin(), weights.end());
+    uint32_t chosen_index = 0;
+    uint32_t deque_chosen_index = 0;
+    BOOST_CHECK_EQUAL(
+        exploration::sample_after_normalizing(seed * 7919, begin(pmf), end(pmf), chosen_index), S_EXPLORATION_OK);
+    BOOST_CHECK_EQUAL(exploration::sample_after_normalizing(
+                          seed * 7919, deque_pmf.begin(), deque_pmf.end(), deque_chosen_index),
+        S_EXPLORATION_OK);
+    BOOST_CHECK_EQUAL(chosen_index, deque_chosen_index);
+    BOOST_CHECK_GT(pmf[chosen_index], 0.f);
+    check_collections_with_float_tolerance(pmf, deque_pmf, .0001f);
+  }
+
+  float x;
+  uint32_t chosen_index;
+  BOOST_CHECK_EQUAL(exploration::sample_after_normalizing("abc", &x, &x - 3, chosen_index), E_EXPLORATION_BAD_RANGE);
+}
@@ -7,6 +7,9 @@
 
 #include <memory>
 #include <array>
+#include <cstdio>
+#include <fstream>
+#include <string>
 
 #include "io/io_adapter.h"
 
@@ -58,3 +61,94 @@ BOOST_AUTO_TEST_CASE(io_adapter_buffer_view)
     BOOST_CHECK_EQUAL(std::strncmp(read_buffer3, "test another", 13), 0);
   }
 }
+
+namespace
+{
+std::string read_all(VW::io::reader& reader)
+{
+  std::string result;
+  char buffer[3];
+  ssize_t num_read;
+  while ((num_read = reader.read(buffer, sizeof(buffer))) > 0) { result.append(buffer, num_read); }
+  return result;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(io_adapter_file_shard_reader)
+{
+  const std::string file_name = "io_adapter_file_shard_reader.txt";
+  const std::string data = "1 | a\n2 | b c\n3 | d\n4 | e f g\n5 | h\n";
+  {
+    std::ofstream file(file_name, std::ios::binary);
+    file << data;
+  }
+
+  for (size_t num_shards = 1; num_shards <= 8; num_shards++)
+  {
+    std::string joined;
+    for (size_t shard = 0; shard < num_shards; shard++)
+    {
+      auto reader = VW::io::open_file_shard_reader(file_name, shard, num_shards, false);
+      const auto part = read_all(*reader);
+      // Shards hold whole lines.
+      BOOST_CHECK(part.empty() || part.back() == '\n');
+      reader->reset();
+      BOOST_CHECK_EQUAL(read_all(*reader), part);
+      joined += part;
+    }
+    BOOST_CHECK_EQUAL(joined, data);
+  }
+  std::remove(file_name.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(io_adapter_file_shard_reader_multiline)
+{
+  const std::string file_name = "io_adapter_file_shard_reader_multiline.txt";
+  const std::string data = "shared | s\n | a\n | b\n\n | c\n\n\nshared | t\n | d\n\n | e\n | f\n\n";
+  {
+    std::ofstream file(file_name, std::ios::binary);
+    file << data;
+  }
+
+  for (size_t num_shards = 1; num_shards <= 8; num_shards++)
+  {
+    std::string joined;
+    for (size_t shard = 0; shard < num_shards; shard++)
+    {
+      auto reader = VW::io::open_file_shard_reader(file_name, shard, num_shards, true);
+      const auto part = read_all(*reader);
+      // Shards end with the empty line of their last example.
+      BOOST_CHECK(part.empty() || part.compare(part.size() - 2, 2, "\n\n") == 0);
+      joined += part;
+    }
+    BOOST_CHECK_EQUAL(joined, data);
+  }
+  std::remove(file_name.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(io_adapter_record_hash_filter)
+{
+  const std::string data = "1 | a\n2 | b c\n3 | d\n4 | e f g\n5 | h\n6 | i\n7 | j\n8 | k\n";
+  const size_t num_shards = 3;
+  std::string joined;
+  for (size_t shard = 0; shard < num_shards; shard++)
+  {
+    auto reader = VW::io::create_record_hash_filter(
+        VW::io::create_buffer_view(data.data(), data.size()), shard, num_shards, false);
+    const auto part = read_all(*reader);
+    BOOST_CHECK(reader->is_resettable());
+    reader->reset();
+    BOOST_CHECK_EQUAL(read_all(*reader), part);
+    joined += part;
+  }
+
+  // Every line is in exactly one shard.
+  BOOST_CHECK_EQUAL(joined.size(), data.size());
+  size_t start = 0;
+  while (start < data.size())
+  {
+    const auto end = data.find('\n', start) + 1;
+    BOOST_CHECK_NE(joined.find(data.substr(start, end - start)), std::string::npos);
+    start = end;
+  }
+}
@@ -0,0 +1,136 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "global_data.h"
+#include "learner.h"
+#include "vw.h"
+#include "vw_exception.h"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr uint32_t num_classes = 10;
+
+// Class c has its own feature plus s<c/2>, which it shares with the other class of its pair (2 and 3, 4 and 5, ...), so
+// the two classes of a pair score high for each other and are picked as hard negatives.
+std::string make_example(uint32_t c)
+{
+  return std::to_string(c) + " | f" + std::to_string(c) + " s" + std::to_string(c / 2);
+}
+
+void train(VW::workspace& vw)
+{
+  for (int pass = 0; pass < 20; pass++)
+  {
+    for (uint32_t c = 1; c <= num_classes; c++)
+    {
+      auto* ex = VW::read_example(vw, make_example(c));
+      vw.learn(*ex);
+      vw.finish_example(*ex);
+    }
+  }
+}
+
+std::vector<uint32_t> train_and_predict(const std::string& args)
+{
+  auto* vw = VW::initialize(args);
+  train(*vw);
+
+  std::vector<uint32_t> predictions;
+  for (uint32_t c = 1; c <= num_classes; c++)
+  {
+    auto* ex = VW::read_example(*vw, make_example(c));
+    vw->predict(*ex);
+    predictions.push_back(ex->pred.multiclass);
+    vw->finish_example(*ex);
+  }
+  VW::finish(*vw);
+  return predictions;
+}
+
+// Weight of the given feature of namespace n for class index l. oaa offsets the weights of class l by l from those of
+// class 0, within the wpp weights of the feature.
+float class_weight(VW::workspace& vw, const std::string& feature, uint32_t l)
+{
+  const uint64_t hash = VW::hash_feature(vw, feature, VW::hash_space(vw, "n"));
+  return vw.weights[(hash * vw.wpp + l) << vw.weights.stride_shift()];
+}
+
+// After training, learns every class once more with a feature that no other example has, so the classes this update
+// touched are the ones with a nonzero weight for it. Returns for every class whether its highest scoring negative, by
+// the scores right before that update, was among them.
+std::vector<bool> highest_scoring_negative_updated(const std::string& args)
+{
+  auto* vw = VW::initialize(args);
+  train(*vw);
+
+  auto* base = VW::LEARNER::as_singleline(vw->l->get_learner_by_name_prefix("oaa")->get_learn_base());
+  std::vector<VW::polyprediction> scores(num_classes);
+  std::vector<bool> updated;
+  for (uint32_t c = 1; c <= num_classes; c++)
+  {
+    const uint32_t true_class = c - 1;
+    const std::string feature = "x" + std::to_string(c);
+    auto* ex = VW::read_example(*vw, make_example(c) + " |n " + feature);
+    base->multipredict(*ex, 0, num_classes, scores.data(), false);
+    uint32_t top_negative = true_class == 0 ? 1 : 0;
+    for (uint32_t l = 0; l < num_classes; l++)
+    {
+      if (l != true_class && scores[l].scalar > scores[top_negative].scalar) { top_negative = l; }
+    }
+    vw->learn(*ex);
+    vw->finish_example(*ex);
+
+    size_t touched = 0;
+    for (uint32_t l = 0; l < num_classes; l++)
+    {
+      if (class_weight(*vw, feature, l) != 0.f) { touched++; }
+    }
+    // the true class and two negatives
+    BOOST_CHECK_EQUAL(touched, 3);
+    updated.push_back(class_weight(*vw, feature, top_negative) != 0.f);
+  }
+  VW::finish(*vw);
+  return updated;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(oaa_hard_negatives_learns_every_class)
+{
+  const auto predictions =
+      train_and_predict("--oaa 10 --oaa_subsample 2 --oaa_hard_negatives 2 --random_seed 3 --quiet");
+  for (uint32_t c = 1; c <= num_classes; c++) { BOOST_CHECK_EQUAL(predictions[c - 1], c); }
+}
+
+BOOST_AUTO_TEST_CASE(oaa_hard_negatives_updates_highest_scoring_negative)
+{
+  // The logistic loss has a nonzero gradient everywhere, so every class that is updated moves its weight.
+  const auto hard = highest_scoring_negative_updated(
+      "--oaa 10 --oaa_subsample 1 --oaa_hard_negatives 1 --loss_function logistic --random_seed 3 --quiet");
+  for (uint32_t c = 1; c <= num_classes; c++) { BOOST_CHECK_MESSAGE(hard[c - 1], "class " << c); }
+
+  // Random negatives miss the highest scoring one most of the time.
+  const auto random =
+      highest_scoring_negative_updated("--oaa 10 --oaa_subsample 2 --loss_function logistic --random_seed 3 --quiet");
+  BOOST_CHECK_LT(std::count(random.begin(), random.end(), true), static_cast<int>(num_classes));
+}
+
+BOOST_AUTO_TEST_CASE(oaa_hard_negatives_covering_all_classes_turns_off_subsampling)
+{
+  // 5 random plus 5 hard negatives cover all 9 negatives, so every class is updated as without subsampling.
+  const auto subsampled = train_and_predict("--oaa 10 --oaa_subsample 5 --oaa_hard_negatives 5 --quiet");
+  const auto full = train_and_predict("--oaa 10 --quiet");
+  BOOST_CHECK_EQUAL_COLLECTIONS(subsampled.begin(), subsampled.end(), full.begin(), full.end());
+}
+
+BOOST_AUTO_TEST_CASE(oaa_hard_negatives_requires_subsample)
+{
+  BOOST_CHECK_THROW(VW::initialize("--oaa 10 --oaa_hard_negatives 2 --quiet"), VW::vw_exception);
+}
@@ -0,0 +1,78 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "global_data.h"
+#include "vw.h"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr int num_labels = 16;
+
+// Every example has two labels, both determined by its features.
+std::string make_example(int i)
+{
+  return std::to_string(i % num_labels) + "," + std::to_string((3 * i + 1) % num_labels) + " | f" +
+      std::to_string(i % num_labels) + " g" + std::to_string(i % 7);
+}
+
+std::vector<std::vector<uint32_t>> train_and_predict_top_k(const std::string& args)
+{
+  auto* vw = VW::initialize(args);
+  for (int pass = 0; pass < 5; pass++)
+  {
+    for (int i = 0; i < 200; i++)
+    {
+      auto* ex = VW::read_example(*vw, make_example(i));
+      vw->learn(*ex);
+      vw->finish_example(*ex);
+    }
+  }
+
+  std::vector<std::vector<uint32_t>> predictions;
+  for (int i = 0; i < 2 * num_labels; i++)
+  {
+    auto* ex = VW::read_example(*vw, make_example(i));
+    vw->predict(*ex);
+    const auto& labels = ex->pred.multilabels.label_v;
+    predictions.emplace_back(labels.begin(), labels.end());
+    vw->finish_example(*ex);
+  }
+  VW::finish(*vw);
+  return predictions;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(plt_wide_beam_predicts_same_top_k_as_best_first)
+{
+  // A beam at least as wide as the widest level of the tree keeps every node, so the search is exact.
+  const std::string args = "--plt 16 --top_k 3 --sgd --quiet";
+  const auto best_first = train_and_predict_top_k(args);
+  const auto beam = train_and_predict_top_k(args + " --plt_beam_size 16");
+
+  BOOST_REQUIRE_EQUAL(best_first.size(), beam.size());
+  for (size_t i = 0; i < best_first.size(); i++)
+  {
+    BOOST_CHECK_EQUAL(best_first[i].size(), 3);
+    BOOST_CHECK_EQUAL_COLLECTIONS(best_first[i].begin(), best_first[i].end(), beam[i].begin(), beam[i].end());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(plt_narrow_beam_still_predicts_top_k_distinct_labels)
+{
+  const auto beam = train_and_predict_top_k("--plt 16 --top_k 3 --sgd --quiet --plt_beam_size 3");
+  for (const auto& labels : beam)
+  {
+    BOOST_REQUIRE_EQUAL(labels.size(), 3);
+    BOOST_CHECK_NE(labels[0], labels[1]);
+    BOOST_CHECK_NE(labels[0], labels[2]);
+    BOOST_CHECK_NE(labels[1], labels[2]);
+    for (const auto label : labels) { BOOST_CHECK_LT(label, static_cast<uint32_t>(num_labels)); }
+  }
+}
@@ -5,6 +5,8 @@
 #include <boost/test/unit_test.hpp>
 
 #include "vwdll.h"
+#include "global_data.h"
+#include "parser.h"
 #include "vw.h"
 #include "test_common.h"
 #include "vw_string_view.h"
@@ -74,6 +76,62 @@ BOOST_AUTO_TEST_CASE(vw_dll_parsed_and_constructed_example_parity)
   VW_Finish(handle2);
 }
 
+BOOST_AUTO_TEST_CASE(vw_dll_predict_batch_matches_single_predictions)
+{
+  VW_HANDLE handle = VW_InitializeA("-q st --quiet");
+  const char* train[] = {"1 |s a b |t x", "-1 |s b c |t y", "1 |s a |t x y", "-1 |s c |t y"};
+  for (int pass = 0; pass < 5; pass++)
+  {
+    for (const char* line : train)
+    {
+      VW_EXAMPLE ex = VW_ReadExampleA(handle, line);
+      VW_Learn(handle, ex);
+      VW_FinishExample(handle, ex);
+    }
+  }
+
+  const auto shash = VW_HashSpaceA(handle, "s");
+  const auto thash = VW_HashSpaceA(handle, "t");
+  // Three examples, the second one without features and the last one with interleaved namespaces.
+  const size_t offsets[] = {0, 3, 3, 6};
+  const unsigned char namespaces[] = {'s', 's', 't', 's', 't', 's'};
+  const size_t hashes[] = {VW_HashFeatureA(handle, "a", shash), VW_HashFeatureA(handle, "b", shash),
+      VW_HashFeatureA(handle, "x", thash), VW_HashFeatureA(handle, "c", shash), VW_HashFeatureA(handle, "y", thash),
+      VW_HashFeatureA(handle, "a", shash)};
+  const float values[] = {1.f, 1.f, 1.f, 0.5f, 1.f, 2.f};
+  const char* lines[] = {"|s a b |t x", "|s", "|s c:0.5 a:2 |t y"};
+
+  float predictions[3];
+  auto batch = VW_CreatePredictBatch(handle);
+  BOOST_REQUIRE(batch != nullptr);
+  auto* all = static_cast<VW::workspace*>(handle);
+  // The second call reuses the example of the first one.
+  for (int repeat = 0; repeat < 2; repeat++)
+  {
+    // Batch predictions are not parsed examples, so they leave the parser counters alone.
+    const uint64_t setup_examples = all->example_parser->num_setup_examples.load();
+    const auto in_pass_counter = all->example_parser->in_pass_counter;
+    BOOST_CHECK_EQUAL(VW_PredictBatch(batch, 3, offsets, namespaces, hashes, values, predictions), 1);
+    BOOST_CHECK_EQUAL(all->example_parser->num_setup_examples.load(), setup_examples);
+    BOOST_CHECK_EQUAL(all->example_parser->in_pass_counter, in_pass_counter);
+    for (size_t i = 0; i < 3; i++)
+    {
+      VW_EXAMPLE ex = VW_ReadExampleA(handle, lines[i]);
+      BOOST_CHECK_CLOSE(predictions[i], VW_Predict(handle, ex), 1e-4f);
+      VW_FinishExample(handle, ex);
+    }
+  }
+  VW_FreePredictBatch(batch);
+  VW_Finish(handle);
+}
+
+BOOST_AUTO_TEST_CASE(vw_dll_predict_batch_rejects_multiline_learners)
+{
+  VW_HANDLE handle = VW_InitializeA("--cb_explore_adf --quiet");
+  BOOST_CHECK(VW_CreatePredictBatch(handle) == nullptr);
+  VW_Finish(handle);
+}
+
 // This test seems to have issues on the older MSVC compiler CI, but no issues in the newer.
 #if (defined(_MSC_VER) && (_MSC_VER >= 1920)) || !defined(_MSC_VER)
 
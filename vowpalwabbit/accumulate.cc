@@ -7,19 +7,380 @@ This implements the allreduce function of MPI.  Code primarily by
 Alekh Agarwal and John Langford, with help Olivier Chapelle.
 */
 
+#include "accumulate.h"
+
 #include "crossplat_compat.h"
 #include "global_data.h"
 #include "vw_allreduce.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <iostream>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <utility>
+#include <vector>
 
 void add_float(float& c1, const float& c2) { c1 += c2; }
 
+uint16_t VW::details::to_bf16(float value)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  bits += 0x7FFF + ((bits >> 16) & 1);  // round to nearest even
+  return static_cast<uint16_t>(bits >> 16);
+}
+
+float VW::details::from_bf16(uint16_t value)
+{
+  const uint32_t bits = static_cast<uint32_t>(value) << 16;
+  float result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+int8_t VW::details::to_int8(float value, float scale)
+{
+  return static_cast<int8_t>(std::max(-127.f, std::min(127.f, std::round(value / scale))));
+}
+
+float VW::details::from_int8(int8_t value, float scale) { return value * scale; }
+
+namespace
+{
+using VW::details::from_bf16;
+using VW::details::to_bf16;
+
+template <class T>
+void add_value(T& c1, const T& c2)
+{
+  c1 += c2;
+}
+
+void add_bf16(uint16_t& c1, const uint16_t& c2) { c1 = to_bf16(from_bf16(c1) + from_bf16(c2)); }
+
+struct float32_codec
+{
+  using type = float;
+  static constexpr bool needs_scale = false;
+  static type encode(float value, float /*scale*/) { return value; }
+  static float decode(type value, float /*scale*/) { return value; }
+};
+
+struct bf16_codec
+{
+  using type = uint16_t;
+  static constexpr bool needs_scale = false;
+  static type encode(float value, float /*scale*/) { return to_bf16(value); }
+  static float decode(type value, float /*scale*/) { return from_bf16(value); }
+};
+
+struct int8_codec
+{
+  using type = int8_t;
+  static constexpr bool needs_scale = true;
+  static type encode(float value, float scale) { return VW::details::to_int8(value, scale); }
+  static float decode(type value, float scale) { return VW::details::from_int8(value, scale); }
+};
+
+// Every node contributes its nonzeros to a buffer of index/value pairs holding the nonzeros of all nodes, each node
+// writing its own segment. Summing that buffer over the nodes is a gather, so the values are added up in float once
+// they have arrived, in node order so that all nodes get the same result.
+template <class codec>
+void sparse_all_reduce(VW::workspace& all, float* values, uint64_t length, const std::vector<uint64_t>& sizes,
+    uint64_t total_nnz, float* residual)
+{
+  using T = typename codec::type;
+  const size_t node = all.all_reduce->node;
+  const uint64_t begin = std::accumulate(sizes.begin(), sizes.begin() + node, static_cast<uint64_t>(0));
+
+  std::vector<float> scales(all.all_reduce->total, 1.f);
+  if (codec::needs_scale)
+  {
+    float max_abs = 0.f;
+    for (uint64_t i = 0; i < length; i++) { max_abs = std::max(max_abs, std::fabs(values[i])); }
+    std::fill(scales.begin(), scales.end(), 0.f);
+    scales[node] = max_abs > 0.f ? max_abs / 127.f : 1.f;
+    all_reduce<float, add_float>(all, scales.data(), scales.size());
+  }
+
+  std::vector<uint32_t> indices(total_nnz, 0);
+  std::vector<T> encoded(total_nnz, 0);
+  uint64_t pos = begin;
+  for (uint64_t i = 0; i < length; i++)
+  {
+    if (values[i] == 0.f)
+    {
+      if (residual != nullptr) { residual[i] = 0.f; }
+      continue;
+    }
+    indices[pos] = static_cast<uint32_t>(i);
+    encoded[pos] = codec::encode(values[i], scales[node]);
+    if (residual != nullptr) { residual[i] = values[i] - codec::decode(encoded[pos], scales[node]); }
+    pos++;
+  }
+
+  all_reduce<uint32_t, add_value<uint32_t>>(all, indices.data(), indices.size());
+  all_reduce<T, add_value<T>>(all, encoded.data(), encoded.size());
+
+  std::fill(values, values + length, 0.f);
+  pos = 0;
+  for (size_t j = 0; j < sizes.size(); j++)
+  {
+    for (const uint64_t end = pos + sizes[j]; pos < end; pos++)
+    { values[indices[pos]] += codec::decode(encoded[pos], scales[j]); }
+  }
+}
+
+void dense_bf16_all_reduce(VW::workspace& all, float* values, uint64_t length, float* residual)
+{
+  std::vector<uint16_t> encoded(length);
+  for (uint64_t i = 0; i < length; i++)
+  {
+    encoded[i] = to_bf16(values[i]);
+    residual[i] = values[i] - from_bf16(encoded[i]);
+  }
+  all_reduce<uint16_t, add_bf16>(all, encoded.data(), length);
+  for (uint64_t i = 0; i < length; i++) { values[i] = from_bf16(encoded[i]); }
+}
+
+}  // namespace
+
+void VW::details::all_reduce_values(VW::workspace& all, float* values, uint64_t length, uint64_t residual_key)
+{
+  AllReduce& ar = *all.all_reduce;
+  // Residuals only exist for quantized transfers, release them if quantization was turned off since.
+  if (ar.quantization == AllReduceQuantization::Float32 && !ar.residuals.empty()) { ar.residuals.clear(); }
+  if (ar.sparse_density <= 0.f && ar.quantization == AllReduceQuantization::Float32)
+  {
+    all_reduce<float, add_float>(all, values, length);
+    return;
+  }
+
+  float* residual = nullptr;
+  if (ar.quantization != AllReduceQuantization::Float32)
+  {
+    auto& stored_residual = ar.residuals[residual_key];
+    if (stored_residual.size() != length) { stored_residual.assign(length, 0.f); }
+    residual = stored_residual.data();
+    for (uint64_t i = 0; i < length; i++) { values[i] += residual[i]; }
+  }
+
+  // indices are sent as 32 bits
+  if (ar.sparse_density > 0.f && length <= (UINT64_ONE << 32))
+  {
+    std::vector<uint64_t> sizes(ar.total, 0);
+    sizes[ar.node] = std::count_if(values, values + length, [](float value) { return value != 0.f; });
+    all_reduce<uint64_t, add_value<uint64_t>>(all, sizes.data(), sizes.size());
+    const uint64_t total_nnz = std::accumulate(sizes.begin(), sizes.end(), static_cast<uint64_t>(0));
+
+    if (total_nnz < ar.sparse_density * length)
+    {
+      switch (ar.quantization)
+      {
+        case AllReduceQuantization::Float32:
+          sparse_all_reduce<float32_codec>(all, values, length, sizes, total_nnz, residual);
+          break;
+        case AllReduceQuantization::BFloat16:
+          sparse_all_reduce<bf16_codec>(all, values, length, sizes, total_nnz, residual);
+          break;
+        case AllReduceQuantization::Int8:
+          sparse_all_reduce<int8_codec>(all, values, length, sizes, total_nnz, residual);
+          break;
+      }
+      return;
+    }
+  }
+
+  // 8 bit values can not be summed in place without overflowing, dense transfers use bfloat16 for both.
+  if (residual != nullptr) { dense_bf16_all_reduce(all, values, length, residual); }
+  else
+  {
+    all_reduce<float, add_float>(all, values, length);
+  }
+}
+
+namespace
+{
+using VW::details::all_reduce_values;
+
+// Error feedback residuals are kept per call site and weight component, so that no two reduced buffers share one.
+enum class residual_site : uint64_t
+{
+  accumulate = 0,
+  accumulate_avg = 1,
+  weighted_avg_weights = 2,  // the summed adaptive component, offset 1, used to weigh the average
+  weighted_avg = 3,          // the whole strided weight array
+};
+
+uint64_t residual_key(residual_site site, uint64_t offset) { return (static_cast<uint64_t>(site) << 32) | offset; }
+
+// Without compression a dense weight component can be reduced where it is, see accumulate() and accumulate_avg().
+bool reduce_in_place(const VW::workspace& all, const parameters& weights)
+{
+  return !weights.sparse && all.all_reduce->sparse_density <= 0.f &&
+      all.all_reduce->quantization == AllReduceQuantization::Float32;
+}
+
+// Reduces the chunks handed to submit() one after the other on a single background thread, which is the only thread
+// that uses the connection while it runs.
+class transfer_thread
+{
+public:
+  explicit transfer_thread(VW::workspace& all) : _all(all), _thread([this] { run(); }) {}
+
+  ~transfer_thread()
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _changed.notify_all();
+    _thread.join();
+  }
+
+  transfer_thread(const transfer_thread&) = delete;
+  transfer_thread& operator=(const transfer_thread&) = delete;
+
+  void submit(float* values, uint64_t count)
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _pending.emplace_back(values, count);
+    }
+    _changed.notify_all();
+  }
+
+  // Blocks until the first num_chunks submitted chunks are reduced. Rethrows the error of a failed transfer.
+  void wait_for(size_t num_chunks)
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _changed.wait(lock, [this, num_chunks] { return _reduced >= num_chunks || _error != nullptr; });
+    if (_error != nullptr) { std::rethrow_exception(_error); }
+  }
+
+private:
+  void run()
+  {
+    while (true)
+    {
+      std::pair<float*, uint64_t> chunk;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _changed.wait(lock, [this] { return _stop || !_pending.empty(); });
+        // Chunks are only left over when the caller gave up on the sync.
+        if (_stop) { return; }
+        chunk = _pending.front();
+        _pending.pop_front();
+      }
+
+      try
+      {
+        all_reduce<float, add_float>(_all, chunk.first, chunk.second);
+      }
+      catch (...)
+      {
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          _error = std::current_exception();
+        }
+        _changed.notify_all();
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _reduced++;
+      }
+      _changed.notify_all();
+    }
+  }
+
+  VW::workspace& _all;
+  std::mutex _mutex;
+  std::condition_variable _changed;
+  std::deque<std::pair<float*, uint64_t>> _pending;
+  size_t _reduced = 0;
+  bool _stop = false;
+  std::exception_ptr _error;
+  std::thread _thread;  // last, so the members it uses exist before it starts
+};
+
+// Reduces length values in chunks. gather(begin, count, values) provides the local values of a chunk and
+// finish(begin, count, values) receives the reduced ones. The chunks are transferred back to back by one background
+// thread while the next chunk is gathered and the one before last is finished, so the copying and post processing
+// hide behind the network.
+template <class G, class F>
+void overlapped_all_reduce(VW::workspace& all, uint64_t length, G gather, F finish)
+{
+  const size_t num_chunks = static_cast<size_t>((length + ar_strided_chunk_size - 1) / ar_strided_chunk_size);
+  auto chunk_begin = [](size_t chunk) { return static_cast<uint64_t>(chunk) * ar_strided_chunk_size; };
+  auto chunk_count = [length, &chunk_begin](size_t chunk) {
+    return std::min<uint64_t>(ar_strided_chunk_size, length - chunk_begin(chunk));
+  };
+
+  // Chunk i is staged in staging[i % 2], one buffer is in flight while the other is gathered or finished.
+  std::vector<float> staging[2];
+  auto finish_chunk = [&](size_t chunk) { finish(chunk_begin(chunk), chunk_count(chunk), staging[chunk % 2].data()); };
+
+  transfer_thread transfers(all);
+  for (size_t chunk = 0; chunk < num_chunks; chunk++)
+  {
+    if (chunk >= 2)
+    {
+      transfers.wait_for(chunk - 1);
+      finish_chunk(chunk - 2);
+    }
+    auto& values = staging[chunk % 2];
+    values.resize(chunk_count(chunk));
+    gather(chunk_begin(chunk), values.size(), values.data());
+    transfers.submit(values.data(), values.size());
+  }
+  for (size_t chunk = num_chunks < 2 ? 0 : num_chunks - 2; chunk < num_chunks; chunk++)
+  {
+    transfers.wait_for(chunk + 1);
+    finish_chunk(chunk);
+  }
+}
+
+// Reduces component[i * stride] for i < length and stores each sum with store(component[i * stride], sum).
+template <class S>
+void reduce_component(VW::workspace& all, float* component, uint64_t length, uint64_t stride, S store)
+{
+  if (all.all_reduce_type == AllReduceType::Thread)
+  {
+    // The threads read each other's weights directly, there is no transfer to overlap with.
+    all_reduce<float, add_float>(all, component, length, stride);
+    for (uint64_t i = 0; i < length; i++) { store(component[i * stride], component[i * stride]); }
+    return;
+  }
+  overlapped_all_reduce(
+      all, length,
+      [component, stride](uint64_t begin, uint64_t count, float* values) {
+        for (uint64_t i = 0; i < count; i++) { values[i] = component[(begin + i) * stride]; }
+      },
+      [component, stride, store](uint64_t begin, uint64_t count, const float* values) {
+        for (uint64_t i = 0; i < count; i++) { store(component[(begin + i) * stride], values[i]); }
+      });
+}
+}  // namespace
+
 void accumulate(VW::workspace& all, parameters& weights, size_t offset)
 {
   uint64_t length = UINT64_ONE << all.num_bits;  // This is size of gradient
+  if (reduce_in_place(all, weights))
+  {
+    reduce_component(all, weights.dense_weights.first() + offset, length, weights.dense_weights.stride(),
+        [](float& weight, float sum) { weight = sum; });
+    return;
+  }
+
   float* local_grad = new float[length];
 
   if (weights.sparse)
@@ -33,7 +394,8 @@ void accumulate(VW::workspace& all, parameters& weights, size_t offset)
     { local_grad[i] = (&(weights.dense_weights[i << weights.dense_weights.stride_shift()]))[offset]; }
   }
 
-  all_reduce<float, add_float>(all, local_grad, length);  // TODO: modify to not use first()
+  // TODO: modify to not use first()
+  all_reduce_values(all, local_grad, length, residual_key(residual_site::accumulate, offset));
 
   if (weights.sparse)
   {
@@ -60,6 +422,13 @@ void accumulate_avg(VW::workspace& all, parameters& weights, size_t offset)
 {
   uint32_t length = 1 << all.num_bits;  // This is size of gradient
   float numnodes = static_cast<float>(all.all_reduce->total);
+  if (reduce_in_place(all, weights))
+  {
+    reduce_component(all, weights.dense_weights.first() + offset, length, weights.dense_weights.stride(),
+        [numnodes](float& weight, float sum) { weight = sum / numnodes; });
+    return;
+  }
+
   float* local_grad = new float[length];
 
   if (weights.sparse)
@@ -73,7 +442,8 @@ void accumulate_avg(VW::workspace& all, parameters& weights, size_t offset)
     { local_grad[i] = (&(weights.dense_weights[i << weights.dense_weights.stride_shift()]))[offset]; }
   }
 
-  all_reduce<float, add_float>(all, local_grad, length);  // TODO: modify to not use first()
+  // TODO: modify to not use first()
+  all_reduce_values(all, local_grad, length, residual_key(residual_site::accumulate_avg, offset));
 
   if (weights.sparse)
   {
@@ -109,12 +479,13 @@ float min_elem(float* arr, int length)
   return min;
 }
 
+// local_weights[i] is the summed weight of parameter begin + i.
 template <class T>
-void do_weighting(VW::workspace& all, uint64_t length, float* local_weights, T& weights)
+void do_weighting(VW::workspace& all, uint64_t begin, uint64_t count, float* local_weights, T& weights)
 {
-  for (uint64_t i = 0; i < length; i++)
+  for (uint64_t i = 0; i < count; i++)
   {
-    float* weight = &weights[i << weights.stride_shift()];
+    float* weight = &weights[(begin + i) << weights.stride_shift()];
     if (local_weights[i] > 0)
     {
       float ratio = weight[1] / local_weights[i];
@@ -143,6 +514,23 @@ void accumulate_weighted_avg(VW::workspace& all, parameters& weights)
   }
 
   uint32_t length = 1 << all.num_bits;  // This is the number of parameters
+  if (reduce_in_place(all, weights))
+  {
+    // The weighting of each chunk overlaps with the transfer of the next one.
+    auto& dense = weights.dense_weights;
+    const uint64_t stride = dense.stride();
+    overlapped_all_reduce(
+        all, length,
+        [&dense, stride](uint64_t begin, uint64_t count, float* values) {
+          for (uint64_t i = 0; i < count; i++) { values[i] = dense.first()[(begin + i) * stride + 1]; }
+        },
+        [&all, &dense](uint64_t begin, uint64_t count, float* values) {
+          do_weighting(all, begin, count, values, dense);
+        });
+    all_reduce<float, add_float>(all, dense.first(), static_cast<size_t>(length) << weights.stride_shift());
+    return;
+  }
+
   float* local_weights = new float[length];
 
   if (weights.sparse)
@@ -157,12 +545,12 @@ void accumulate_weighted_avg(VW::workspace& all, parameters& weights)
   }
 
   // First compute weights for averaging
-  all_reduce<float, add_float>(all, local_weights, length);
+  all_reduce_values(all, local_weights, length, residual_key(residual_site::weighted_avg_weights, 1));
 
-  if (weights.sparse) { do_weighting(all, length, local_weights, weights.sparse_weights); }
+  if (weights.sparse) { do_weighting(all, 0, length, local_weights, weights.sparse_weights); }
   else
   {
-    do_weighting(all, length, local_weights, weights.dense_weights);
+    do_weighting(all, 0, length, local_weights, weights.dense_weights);
   }
 
   if (weights.sparse)
@@ -172,8 +560,8 @@ void accumulate_weighted_avg(VW::workspace& all, parameters& weights)
   }
   else
   {
-    all_reduce<float, add_float>(
-        all, weights.dense_weights.first(), (static_cast<size_t>(length)) * (1ull << weights.stride_shift()));
+    all_reduce_values(all, weights.dense_weights.first(),
+        (static_cast<size_t>(length)) * (1ull << weights.stride_shift()), residual_key(residual_site::weighted_avg, 0));
   }
   delete[] local_weights;
 }
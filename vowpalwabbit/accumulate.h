@@ -8,8 +8,25 @@
 #include "vw_fwd.h"
 
 #include <cstddef>
+#include <cstdint>
 
 void accumulate(VW::workspace& all, parameters& weights, size_t o);
 float accumulate_scalar(VW::workspace& all, float local_sum);
 void accumulate_weighted_avg(VW::workspace& all, parameters& weights);
 void accumulate_avg(VW::workspace& all, parameters& weights, size_t o);
+
+namespace VW
+{
+namespace details
+{
+// Value encodings of synced weights, see AllReduceQuantization.
+uint16_t to_bf16(float value);
+float from_bf16(uint16_t value);
+int8_t to_int8(float value, float scale);
+float from_int8(int8_t value, float scale);
+
+// Sums values over all nodes in place, using the sparse and quantized encodings configured on all.all_reduce.
+// residual_key identifies the buffer across calls for error feedback.
+void all_reduce_values(VW::workspace& all, float* values, uint64_t length, uint64_t residual_key);
+}  // namespace details
+}  // namespace VW
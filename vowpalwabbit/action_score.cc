@@ -11,15 +11,32 @@
 #include "v_array.h"
 #include "vw_string_view.h"
 
+namespace
+{
+std::string format_action_scores(
+    const ACTION_SCORE::action_scores& action_scores_or_probs, size_t count, int decimal_precision)
+{
+  std::ostringstream ss;
+  std::string delim;
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto& item = action_scores_or_probs[i];
+    ss << delim << fmt::format("{},{}", item.action, VW::fmt_float(item.score, decimal_precision));
+    delim = ",";
+  }
+  return ss.str();
+}
+}  // namespace
+
 namespace ACTION_SCORE
 {
-void print_action_score(
-    VW::io::writer* f, const VW::v_array<action_score>& a_s, const VW::v_array<char>& tag, VW::io::logger& logger)
+void print_action_score(VW::io::writer* f, const VW::v_array<action_score>& a_s, const VW::v_array<char>& tag,
+    VW::io::logger& logger, size_t max_actions)
 {
   if (f == nullptr) { return; }
 
   std::stringstream ss;
-  ss << VW::to_string(a_s);
+  ss << format_action_scores(a_s, (std::min)(max_actions, a_s.size()), VW::DEFAULT_FLOAT_PRECISION);
   if (!tag.empty()) { ss << " " << VW::string_view(tag.begin(), tag.size()); }
   ss << '\n';
   const auto ss_str = ss.str();
@@ -39,14 +56,7 @@ namespace VW
 {
 std::string to_string(const ACTION_SCORE::action_scores& action_scores_or_probs, int decimal_precision)
 {
-  std::ostringstream ss;
-  std::string delim;
-  for (const auto& item : action_scores_or_probs)
-  {
-    ss << delim << fmt::format("{},{}", item.action, VW::fmt_float(item.score, decimal_precision));
-    delim = ",";
-  }
-  return ss.str();
+  return format_action_scores(action_scores_or_probs, action_scores_or_probs.size(), decimal_precision);
 }
 
 }  // namespace VW
\ No newline at end of file
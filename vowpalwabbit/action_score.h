@@ -8,7 +8,10 @@
 #include "v_array.h"
 #include "vw_fwd.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <iterator>
+#include <limits>
 #include <string>
 
 namespace ACTION_SCORE
@@ -57,8 +60,9 @@ inline score_iterator begin_scores(action_scores& a_s) { return {a_s.begin()}; }
 
 inline score_iterator end_scores(action_scores& a_s) { return {a_s.end()}; }
 
-void print_action_score(
-    VW::io::writer* f, const VW::v_array<action_score>& a_s, const VW::v_array<char>&, VW::io::logger& logger);
+// Prints at most max_actions entries of a_s.
+void print_action_score(VW::io::writer* f, const VW::v_array<action_score>& a_s, const VW::v_array<char>&,
+    VW::io::logger& logger, size_t max_actions = std::numeric_limits<size_t>::max());
 
 std::ostream& operator<<(std::ostream& os, const action_score& a_s);
 }  // namespace ACTION_SCORE
@@ -76,6 +80,24 @@ constexpr inline bool action_score_compare_gt(
   return (left.score == right.score) ? left.action > right.action : left.score > right.score;
 }
 
+// Moves the k first elements of the order induced by comp to the front of the range, sorted. The rest of the range is
+// left in unspecified order. Selection is linear, so only the k front elements pay for the sort.
+template <typename RandomIt, typename Compare>
+void sort_top_k(RandomIt first, RandomIt last, size_t k, Compare comp)
+{
+  const auto size = static_cast<size_t>(std::distance(first, last));
+  if (k >= size)
+  {
+    std::sort(first, last, comp);
+    return;
+  }
+  if (k == 0) { return; }
+
+  const RandomIt kth = first + (k - 1);
+  std::nth_element(first, kth, last, comp);
+  std::sort(first, kth, comp);
+}
+
 std::string to_string(
     const ACTION_SCORE::action_scores& action_scores_or_probs, int decimal_precision = DEFAULT_FLOAT_PRECISION);
 }  // namespace VW
\ No newline at end of file
@@ -6,8 +6,12 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #ifdef _WIN32
 #  ifndef NOMINMAX
@@ -38,6 +42,7 @@ class promise;
 #  include <stdlib.h>
 #  include <string.h>
 #  include <sys/socket.h>
+#  include <sys/time.h>
 #  include <unistd.h>
 using socket_t = int;
 #  define CLOSESOCK close
@@ -62,11 +67,38 @@ using socket_t = int;
 #endif
 
 constexpr size_t ar_buf_size = 1 << 16;
+#ifdef MSG_NOSIGNAL
+// A node that went away must surface as a failed send rather than a SIGPIPE.
+constexpr int ar_send_flags = MSG_NOSIGNAL;
+#else
+constexpr int ar_send_flags = 0;
+#endif
+// Number of elements staged at a time when a strided buffer is reduced over sockets.
+constexpr size_t ar_strided_chunk_size = 1 << 18;
+// Bytes per process staged at a time through shared memory.
+constexpr size_t ar_shm_slot_size = 1 << 20;
 
 enum class AllReduceType
 {
   Socket,
-  Thread
+  Thread,
+  SharedMemory
+};
+
+// How AllReduceSockets moves the data once the nodes have met at the span server.
+enum class AllReduceAlgorithm
+{
+  Tree,              // reduce up and broadcast down the binary spanning tree
+  Ring,              // reduce-scatter and allgather around a ring of all nodes
+  RecursiveHalving,  // recursive halving reduce-scatter and recursive doubling allgather, power of two nodes only
+};
+
+// Value encoding used by accumulate() and friends to transfer weights and gradients.
+enum class AllReduceQuantization
+{
+  Float32,   // exact
+  BFloat16,  // upper half of the float, round to nearest even
+  Int8,      // per node scale, only used for sparse transfers; dense transfers use BFloat16
 };
 
 struct node_socks
@@ -74,6 +106,9 @@ struct node_socks
   std::string current_master;
   socket_t parent;
   socket_t children[2];
+  // Direct connections to other nodes indexed by node id, -1 if not connected. Only used by the ring and recursive
+  // halving algorithms.
+  std::vector<socket_t> peers;
   ~node_socks()
   {
     if (current_master != "")
@@ -81,6 +116,10 @@ struct node_socks
       if (parent != -1) CLOSESOCK(this->parent);
       if (children[0] != -1) CLOSESOCK(this->children[0]);
       if (children[1] != -1) CLOSESOCK(this->children[1]);
+      for (socket_t peer : peers)
+      {
+        if (peer != -1) CLOSESOCK(peer);
+      }
     }
   }
   node_socks() { current_master = ""; }
@@ -99,6 +138,15 @@ public:
   const size_t node;   // node id number
   bool quiet;
 
+  // accumulate() sends index/value pairs instead of the whole buffer while the number of nonzeros summed over all
+  // nodes is below sparse_density times the buffer length. 0 always sends the whole buffer.
+  float sparse_density = 0.f;
+  AllReduceQuantization quantization = AllReduceQuantization::Float32;
+  // Quantization error of the last accumulate of each buffer, added to the next one (error feedback). Each residual
+  // is as long as its buffer, so weighted averaging keeps a float copy of the whole strided weight array here. They
+  // are only allocated while quantization is on.
+  std::map<uint64_t, std::vector<float>> residuals;
+
   AllReduce(size_t ptotal, const size_t pnode, bool pquiet = false) : total(ptotal), node(pnode), quiet(pquiet)
   {
     assert(node < total);
@@ -151,8 +199,10 @@ public:
 
   virtual ~AllReduceThreads();
 
+  // Reduces buffer[i * stride] for i < n in place. The other threads' buffers are read directly, so a stride just
+  // skips the interleaved elements without any copy.
   template <class T, void (*f)(T&, const T&)>
-  void all_reduce(T* buffer, const size_t n)
+  void all_reduce(T* buffer, const size_t n, const size_t stride = 1)
   {  // register buffer
     T** buffers = (T**)m_sync->buffers;
     buffers[node] = buffer;
@@ -182,12 +232,12 @@ public:
 
     for (; index < end; index++)
     {  // Perform transposed AllReduce to help data locallity
-      T& first = buffers[0][index];
+      T& first = buffers[0][index * stride];
 
-      for (size_t i = 1; i < total; i++) f(first, buffers[i][index]);
+      for (size_t i = 1; i < total; i++) f(first, buffers[i][index * stride]);
 
       // Broadcast back
-      for (size_t i = 1; i < total; i++) buffers[i][index] = first;
+      for (size_t i = 1; i < total; i++) buffers[i][index * stride] = first;
     }
 
     m_sync->waitForSynchronization();
@@ -201,8 +251,25 @@ private:
   std::string span_server;
   int port;
   size_t unique_id;  // unique id for each node in the network, id == 0 means extra io.
+  AllReduceAlgorithm algorithm;
+  uint32_t local_ip = 0;  // address of this node as used to reach the span server, in network order
+  size_t epoch = 0;       // membership epoch of the current spanning tree, assigned by the span server
+  bool check_membership = false;
+  bool registered_epochs = false;  // the span server tracks epochs for this job
+  bool sync_failed = false;        // an all_reduce gave up, other nodes may still need the epochs
+  uint64_t completed_calls = 0;
 
   void all_reduce_init(VW::io::logger& logger);
+  // Closes all connections, the next all_reduce registers at the span server again.
+  void reset_connections();
+  void configure_socket(socket_t sock, bool blocking);
+  // Run by every node of a tree rebuilt after a failure before the first transfer. Throws
+  // allreduce_rejoin_exception if the nodes are not at the same synchronization point.
+  void check_rejoin(size_t n, VW::io::logger& logger);
+  void connect_peers(VW::io::logger& logger);
+  // Sends send_size bytes to send_sock while receiving recv_size bytes from recv_sock.
+  void exchange(socket_t send_sock, const char* send_buf, size_t send_size, socket_t recv_sock, char* recv_buf,
+      size_t recv_size);
 
   template <class T>
   void pass_up(char* buffer, size_t left_read_pos, size_t right_read_pos, size_t& parent_sent_pos)
@@ -212,7 +279,7 @@ private:
 
     if (my_bufsize > 0)
     {  // going to pass up this chunk of data to the parent
-      int write_size = send(socks.parent, buffer + parent_sent_pos, static_cast<int>(my_bufsize), 0);
+      int write_size = send(socks.parent, buffer + parent_sent_pos, static_cast<int>(my_bufsize), ar_send_flags);
       if (write_size < 0)
         THROW("Write to parent failed " << my_bufsize << " " << write_size << " " << parent_sent_pos << " "
                                         << left_read_pos << " " << right_read_pos);
@@ -248,7 +315,13 @@ private:
 
       if (child_read_pos[0] < n || child_read_pos[1] < n)
       {
-        if (max_fd > 0 && select(static_cast<int>(max_fd), &fds, nullptr, nullptr, nullptr) == -1) THROWERRNO("select");
+        if (max_fd > 0)
+        {
+          timeval timeout;
+          const int ready = select(static_cast<int>(max_fd), &fds, nullptr, nullptr, select_timeout(timeout));
+          if (ready == -1) THROWERRNO("select");
+          if (ready == 0) THROW("Timed out waiting for data from a child");
+        }
 
         for (int i = 0; i < 2; i++)
         {
@@ -262,6 +335,7 @@ private:
             int read_size =
                 recv(socks.children[i], &child_read_buf[i][child_unprocessed[i]], static_cast<int>(count), 0);
             if (read_size == -1) THROWERRNO("recv from child");
+            if (read_size == 0) THROW("Child closed the connection");
 
             addbufs<T, f>((T*)buffer + child_read_pos[i] / sizeof(T), (T*)child_read_buf[i],
                 (child_read_pos[i] + read_size) / sizeof(T) - child_read_pos[i] / sizeof(T));
@@ -289,23 +363,267 @@ private:
   void pass_down(char* buffer, const size_t parent_read_pos, size_t& children_sent_pos);
   void broadcast(char* buffer, const size_t n);
 
+  // Every node sends and receives 2 * (total - 1) / total of the buffer, independent of the number of nodes.
+  template <class T, void (*f)(T&, const T&)>
+  void ring_all_reduce(T* buffer, const size_t n)
+  {
+    // chunk c covers [chunk_begin(c), chunk_begin(c + 1)), the first n % total chunks get one extra element
+    const auto chunk_begin = [this, n](size_t c) { return c * (n / total) + std::min(c, n % total); };
+    const socket_t next = socks.peers[(node + 1) % total];
+    const socket_t prev = socks.peers[(node + total - 1) % total];
+    std::vector<T> recv_buf(n / total + 1);
+
+    // reduce-scatter: after total - 1 steps this node holds the fully reduced chunk (node + 1) % total
+    for (size_t step = 0; step + 1 < total; step++)
+    {
+      const size_t send_chunk = (node + total - step) % total;
+      const size_t recv_chunk = (node + total - step - 1) % total;
+      const size_t send_count = chunk_begin(send_chunk + 1) - chunk_begin(send_chunk);
+      const size_t recv_count = chunk_begin(recv_chunk + 1) - chunk_begin(recv_chunk);
+      exchange(next, reinterpret_cast<const char*>(buffer + chunk_begin(send_chunk)), send_count * sizeof(T), prev,
+          reinterpret_cast<char*>(recv_buf.data()), recv_count * sizeof(T));
+      addbufs<T, f>(buffer + chunk_begin(recv_chunk), recv_buf.data(), recv_count);
+    }
+
+    // allgather: pass the reduced chunks around the ring
+    for (size_t step = 0; step + 1 < total; step++)
+    {
+      const size_t send_chunk = (node + 1 + total - step) % total;
+      const size_t recv_chunk = (node + total - step) % total;
+      const size_t send_count = chunk_begin(send_chunk + 1) - chunk_begin(send_chunk);
+      const size_t recv_count = chunk_begin(recv_chunk + 1) - chunk_begin(recv_chunk);
+      exchange(next, reinterpret_cast<const char*>(buffer + chunk_begin(send_chunk)), send_count * sizeof(T), prev,
+          reinterpret_cast<char*>(buffer + chunk_begin(recv_chunk)), recv_count * sizeof(T));
+    }
+  }
+
+  // Same volume as the ring in 2 * log2(total) steps instead of 2 * (total - 1). Requires total to be a power of two.
+  template <class T, void (*f)(T&, const T&)>
+  void recursive_halving_all_reduce(T* buffer, const size_t n)
+  {
+    std::vector<std::pair<size_t, size_t>> ranges;  // range owned before each halving step
+    std::vector<T> recv_buf(n / 2 + 1);
+    size_t begin = 0;
+    size_t end = n;
+
+    // reduce-scatter: exchange half of the current range with the partner and keep reducing the other half
+    for (size_t distance = total / 2; distance >= 1; distance /= 2)
+    {
+      const socket_t peer = socks.peers[node ^ distance];
+      const size_t mid = begin + (end - begin) / 2;
+      const bool keep_lower = (node & distance) == 0;
+      const size_t send_begin = keep_lower ? mid : begin;
+      const size_t send_end = keep_lower ? end : mid;
+      const size_t keep_begin = keep_lower ? begin : mid;
+      const size_t keep_end = keep_lower ? mid : end;
+
+      exchange(peer, reinterpret_cast<const char*>(buffer + send_begin), (send_end - send_begin) * sizeof(T), peer,
+          reinterpret_cast<char*>(recv_buf.data()), (keep_end - keep_begin) * sizeof(T));
+      addbufs<T, f>(buffer + keep_begin, recv_buf.data(), keep_end - keep_begin);
+
+      ranges.emplace_back(begin, end);
+      begin = keep_begin;
+      end = keep_end;
+    }
+
+    // allgather: recursive doubling, the partner owns the other half of the range of the matching halving step
+    for (size_t distance = 1; distance < total; distance *= 2)
+    {
+      const socket_t peer = socks.peers[node ^ distance];
+      const auto parent = ranges.back();
+      ranges.pop_back();
+      const bool own_lower = begin == parent.first;
+      const size_t other_begin = own_lower ? end : parent.first;
+      const size_t other_end = own_lower ? parent.second : begin;
+
+      exchange(peer, reinterpret_cast<const char*>(buffer + begin), (end - begin) * sizeof(T), peer,
+          reinterpret_cast<char*>(buffer + other_begin), (other_end - other_begin) * sizeof(T));
+
+      begin = parent.first;
+      end = parent.second;
+    }
+  }
+
   socket_t sock_connect(const uint32_t ip, const int port, VW::io::logger& logger);
   socket_t getsock(VW::io::logger& logger);
 
+  // Timeout of a single select call, nullptr waits indefinitely.
+  timeval* select_timeout(timeval& timeout) const
+  {
+    if (timeout_seconds <= 0.f) { return nullptr; }
+    timeout.tv_sec = static_cast<long>(timeout_seconds);
+    timeout.tv_usec = static_cast<long>((timeout_seconds - timeout.tv_sec) * 1e6f);
+    return &timeout;
+  }
+
+  template <class T, void (*f)(T&, const T&)>
+  void all_reduce_once(T* buffer, const size_t n, VW::io::logger& logger)
+  {
+    if (span_server != socks.current_master) all_reduce_init(logger);
+    if (check_membership) { check_rejoin(n, logger); }
+
+    // Small buffers (scalars, counts) are latency bound, the tree needs the fewest round trips for those.
+    if (algorithm == AllReduceAlgorithm::Tree || n < total || n * sizeof(T) < ar_buf_size)
+    {
+      reduce<T, f>((char*)buffer, n * sizeof(T));
+      broadcast((char*)buffer, n * sizeof(T));
+    }
+    else if (algorithm == AllReduceAlgorithm::Ring) { ring_all_reduce<T, f>(buffer, n); }
+    else
+    {
+      recursive_halving_all_reduce<T, f>(buffer, n);
+    }
+    completed_calls++;
+  }
+
 public:
+  // A transfer that makes no progress for this many seconds fails. 0 waits indefinitely. Nodes wait for each other
+  // at every sync, so this has to exceed the difference in running time between the nodes.
+  float timeout_seconds = 0.f;
+  // Interval of the TCP keepalive probes that detect dead nodes while no data is transferred. 0 keeps the system
+  // default.
+  float heartbeat_seconds = 0.f;
+  // How often a failed all_reduce rebuilds the spanning tree and starts over. 0 fails on the first error.
+  size_t max_retries = 0;
+
   AllReduceSockets(std::string pspan_server, const int pport, const size_t punique_id, size_t ptotal,
-      const size_t pnode, bool pquiet)
-      : AllReduce(ptotal, pnode, pquiet), span_server(std::move(pspan_server)), port(pport), unique_id(punique_id)
+      const size_t pnode, bool pquiet, AllReduceAlgorithm palgorithm = AllReduceAlgorithm::Tree)
+      : AllReduce(ptotal, pnode, pquiet)
+      , span_server(std::move(pspan_server))
+      , port(pport)
+      , unique_id(punique_id)
+      , algorithm(palgorithm)
   {
   }
 
-  virtual ~AllReduceSockets() = default;
+  // Node 0 of a job that retries tells the span server that the job is done, unless a sync failed.
+  virtual ~AllReduceSockets();
 
   template <class T, void (*f)(T&, const T&)>
   void all_reduce(T* buffer, const size_t n, VW::io::logger& logger)
   {
-    if (span_server != socks.current_master) all_reduce_init(logger);
-    reduce<T, f>((char*)buffer, n * sizeof(T));
-    broadcast((char*)buffer, n * sizeof(T));
+    if (max_retries == 0)
+    {
+      all_reduce_once<T, f>(buffer, n, logger);
+      return;
+    }
+
+    // The buffer is summed in place, a failed attempt has to start over from the local values.
+    const std::vector<T> input(buffer, buffer + n);
+    for (size_t attempt = 0;; attempt++)
+    {
+      try
+      {
+        all_reduce_once<T, f>(buffer, n, logger);
+        return;
+      }
+      catch (const VW::allreduce_rejoin_exception&)
+      {
+        sync_failed = true;
+        throw;
+      }
+      catch (const VW::vw_exception& e)
+      {
+        if (attempt >= max_retries)
+        {
+          sync_failed = true;
+          throw;
+        }
+        logger.err_warn("allreduce failed: {}. Rebuilding the spanning tree, retry {} of {}", e.what(), attempt + 1,
+            max_retries);
+        reset_connections();
+        std::copy(input.begin(), input.end(), buffer);
+      }
+    }
+  }
+
+  // Reduces buffer[i * stride] for i < n in place. Elements are staged through a scratch buffer of at most
+  // ar_strided_chunk_size elements, so the whole component is never copied at once.
+  template <class T, void (*f)(T&, const T&)>
+  void all_reduce(T* buffer, const size_t n, const size_t stride, VW::io::logger& logger)
+  {
+    if (stride == 1)
+    {
+      all_reduce<T, f>(buffer, n, logger);
+      return;
+    }
+
+    std::vector<T> chunk(std::min(n, ar_strided_chunk_size));
+    for (size_t begin = 0; begin < n; begin += chunk.size())
+    {
+      const size_t count = std::min(chunk.size(), n - begin);
+      T* strided = buffer + begin * stride;
+      for (size_t i = 0; i < count; i++) { chunk[i] = strided[i * stride]; }
+      all_reduce<T, f>(chunk.data(), count, logger);
+      for (size_t i = 0; i < count; i++) { strided[i * stride] = chunk[i]; }
+    }
+  }
+};
+
+// Processes on the same host sync through a POSIX shared memory segment instead of loopback TCP. Process local_node of
+// local_total on a host is node host * local_total + local_node of the cluster. If there is more than one host, the
+// first process of each host then syncs the sum of its host with the other hosts over hosts.
+class AllReduceSharedMemory : public AllReduce
+{
+private:
+  struct shm_header;
+
+  std::string name;
+  size_t local_total;
+  size_t local_node;
+  size_t num_hosts;
+  std::unique_ptr<AllReduceSockets> hosts;  // only set on the first process of each host
+  shm_header* header = nullptr;
+  char* slots = nullptr;  // local_total input slots followed by two result slots
+  size_t mapping_size = 0;
+  uint64_t chunks_done = 0;
+
+  void barrier();
+  char* slot(size_t index) const { return slots + index * ar_shm_slot_size; }
+
+public:
+  // A segment left behind by a crashed job under the same name has to be removed from /dev/shm before restarting.
+  AllReduceSharedMemory(std::string pname, size_t plocal_total, size_t plocal_node,
+      std::unique_ptr<AllReduceSockets> phosts, size_t ptotal, size_t pnode, bool pquiet = false);
+  virtual ~AllReduceSharedMemory();
+
+  AllReduceSharedMemory(const AllReduceSharedMemory&) = delete;
+  AllReduceSharedMemory& operator=(const AllReduceSharedMemory&) = delete;
+
+  // Reduces buffer[i * stride] for i < n in place.
+  template <class T, void (*f)(T&, const T&)>
+  void all_reduce(T* buffer, const size_t n, const size_t stride, VW::io::logger& logger)
+  {
+    const size_t chunk_size = ar_shm_slot_size / sizeof(T);
+    for (size_t begin = 0; begin < n; begin += chunk_size)
+    {
+      const size_t count = std::min(chunk_size, n - begin);
+      T* data = buffer + begin * stride;
+      T* own = reinterpret_cast<T*>(slot(local_node));
+      for (size_t i = 0; i < count; i++) { own[i] = data[i * stride]; }
+      barrier();
+
+      // Every process sums its share of the chunk over all processes. The result slots alternate between chunks, so
+      // that a process can only start writing the next result after everybody copied the previous one out.
+      T* result = reinterpret_cast<T*>(slot(local_total + chunks_done % 2));
+      const size_t share_begin = count * local_node / local_total;
+      const size_t share_end = count * (local_node + 1) / local_total;
+      const T* first = reinterpret_cast<const T*>(slot(0));
+      std::copy(first + share_begin, first + share_end, result + share_begin);
+      for (size_t p = 1; p < local_total; p++)
+      {
+        addbufs<T, f>(
+            result + share_begin, reinterpret_cast<const T*>(slot(p)) + share_begin, share_end - share_begin);
+      }
+      barrier();
+
+      if (num_hosts > 1)
+      {
+        if (hosts != nullptr) { hosts->all_reduce<T, f>(result, count, logger); }
+        barrier();
+      }
+      for (size_t i = 0; i < count; i++) { data[i * stride] = result[i]; }
+      chunks_done++;
+    }
   }
 };
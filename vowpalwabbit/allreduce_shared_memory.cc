@@ -0,0 +1,144 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+/*
+This implements the allreduce function between processes of one host using POSIX shared memory.
+*/
+#include "allreduce.h"
+
+#include <atomic>
+#include <climits>
+#include <thread>
+
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+#ifdef __linux__
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#endif
+
+// Lock free atomics are address free, so they work between processes that map the same memory.
+struct AllReduceSharedMemory::shm_header
+{
+  std::atomic<uint32_t> arrived;
+  std::atomic<uint32_t> generation;
+  std::atomic<uint32_t> sleeping;
+  std::atomic<uint32_t> attached;
+};
+
+namespace
+{
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex needs a plain 32 bit word");
+
+// The slots start after the header, aligned to a cache line.
+constexpr size_t SHM_HEADER_SIZE = 64;
+static_assert(ar_shm_slot_size % SHM_HEADER_SIZE == 0, "slots must stay aligned");
+
+// Number of checks of the barrier before a waiting process goes to sleep. Syncs of neighboring chunks follow
+// each other closely, sleeping right away would make every barrier a round trip through the scheduler.
+constexpr int BARRIER_SPINS = 4096;
+
+#ifdef __linux__
+void futex_wait(std::atomic<uint32_t>& word, uint32_t value)
+{
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, value, nullptr, nullptr, 0);
+}
+
+void futex_wake_all(std::atomic<uint32_t>& word)
+{
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+#endif
+}  // namespace
+
+#ifdef _WIN32
+AllReduceSharedMemory::AllReduceSharedMemory(std::string pname, size_t plocal_total, size_t plocal_node,
+    std::unique_ptr<AllReduceSockets> phosts, size_t ptotal, size_t pnode, bool pquiet)
+    : AllReduce(ptotal, pnode, pquiet)
+    , name(std::move(pname))
+    , local_total(plocal_total)
+    , local_node(plocal_node)
+    , num_hosts(ptotal / plocal_total)
+    , hosts(std::move(phosts))
+{
+  THROW("Shared memory allreduce is not supported on Windows");
+}
+
+AllReduceSharedMemory::~AllReduceSharedMemory() = default;
+
+void AllReduceSharedMemory::barrier() {}
+#else
+AllReduceSharedMemory::AllReduceSharedMemory(std::string pname, size_t plocal_total, size_t plocal_node,
+    std::unique_ptr<AllReduceSockets> phosts, size_t ptotal, size_t pnode, bool pquiet)
+    : AllReduce(ptotal, pnode, pquiet)
+    , name(std::move(pname))
+    , local_total(plocal_total)
+    , local_node(plocal_node)
+    , num_hosts(ptotal / plocal_total)
+    , hosts(std::move(phosts))
+{
+  if (local_total == 0 || total % local_total != 0)
+    THROW("The number of nodes " << total << " is not a multiple of the nodes per host " << local_total);
+  if (local_node >= local_total) THROW("Local node " << local_node << " out of range for " << local_total);
+  if (num_hosts > 1 && local_node == 0 && hosts == nullptr)
+    THROW("The first process of a host needs a connection to the other hosts");
+
+  mapping_size = SHM_HEADER_SIZE + (local_total + 2) * ar_shm_slot_size;
+
+  // Every process creates the segment if needed. A new segment is zero filled, which is the initial barrier state.
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd == -1) THROWERRNO("shm_open(" << name << ")");
+  if (ftruncate(fd, static_cast<off_t>(mapping_size)) == -1)
+  {
+    close(fd);
+    THROWERRNO("ftruncate(" << name << ")");
+  }
+  void* mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) THROWERRNO("mmap(" << name << ")");
+
+  header = static_cast<shm_header*>(mapping);
+  slots = static_cast<char*>(mapping) + SHM_HEADER_SIZE;
+  header->attached.fetch_add(1);
+}
+
+AllReduceSharedMemory::~AllReduceSharedMemory()
+{
+  if (header == nullptr) { return; }
+  // The last process to leave removes the segment.
+  if (header->attached.fetch_sub(1) == 1) { shm_unlink(name.c_str()); }
+  munmap(header, mapping_size);
+}
+
+void AllReduceSharedMemory::barrier()
+{
+  const uint32_t generation = header->generation.load(std::memory_order_acquire);
+  if (header->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == local_total)
+  {
+    header->arrived.store(0, std::memory_order_relaxed);
+    header->generation.fetch_add(1);
+#  ifdef __linux__
+    if (header->sleeping.load() > 0) { futex_wake_all(header->generation); }
+#  endif
+    return;
+  }
+
+  for (int spins = 0; header->generation.load(std::memory_order_acquire) == generation; spins++)
+  {
+    if (spins < BARRIER_SPINS) { continue; }
+#  ifdef __linux__
+    // sleeping is raised before the generation is checked again by the futex, so the last process to arrive either
+    // sees a sleeper and wakes it or the futex sees the new generation and returns right away.
+    header->sleeping.fetch_add(1);
+    futex_wait(header->generation, generation);
+    header->sleeping.fetch_sub(1);
+#  else
+    std::this_thread::yield();
+#  endif
+  }
+}
+#endif
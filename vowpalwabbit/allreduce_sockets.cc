@@ -26,14 +26,41 @@ Alekh Agarwal and John Langford, with help Olivier Chapelle.
 #  include <io.h>
 #else
 #  include <arpa/inet.h>
+#  include <fcntl.h>
 #  include <unistd.h>
 #endif
 #include "allreduce.h"
 #include "io/logger.h"
+#include "spanning_tree.h"
 #include "vw_exception.h"
 
 #include <sys/timeb.h>
 
+namespace
+{
+void add_uint64(uint64_t& a, const uint64_t& b) { a += b; }
+
+void set_nonblocking(socket_t sock)
+{
+#ifdef _WIN32
+  u_long mode = 1;
+  if (ioctlsocket(sock, FIONBIO, &mode) != 0) THROWERRNO("ioctlsocket");
+#else
+  int flags = fcntl(sock, F_GETFL, 0);
+  if (flags == -1 || fcntl(sock, F_SETFL, flags | O_NONBLOCK) == -1) THROWERRNO("fcntl");
+#endif
+}
+
+bool would_block()
+{
+#ifdef _WIN32
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+}  // namespace
+
 // port is already in network order
 socket_t AllReduceSockets::sock_connect(const uint32_t ip, const int port, VW::io::logger& logger)
 {
@@ -132,7 +159,11 @@ void AllReduceSockets::all_reduce_init(VW::io::logger& logger)
   {
     logger.err_info("wrote total={}", total);
   }
-  if (send(master_sock, (char*)&node, sizeof(node), 0) < static_cast<int>(sizeof(node)))
+  // Only nodes that retry need the epoch, so jobs without retries also work with older span servers.
+  const bool request_epoch = max_retries > 0;
+  const size_t node_request = request_epoch ? node | VW::SPAN_REQUEST_EPOCH : node;
+  if (send(master_sock, reinterpret_cast<const char*>(&node_request), sizeof(node_request), 0) <
+      static_cast<int>(sizeof(node_request)))
   { THROW("Write node=" << node << " to span server failed"); }
   else
   {
@@ -145,7 +176,23 @@ void AllReduceSockets::all_reduce_init(VW::io::logger& logger)
   {
     logger.err_info("Read ok={}", ok);
   }
-  if (!ok) THROW("Mapper already connected");
+  if (!ok)
+  {
+    if (request_epoch) THROW("Mapper already connected, or the span server is too old for --allreduce_retries");
+    THROW("Mapper already connected");
+  }
+  if (request_epoch)
+  {
+    if (recv(master_sock, reinterpret_cast<char*>(&epoch), sizeof(epoch), 0) < static_cast<int>(sizeof(epoch)))
+    { THROW("Read epoch from span server failed"); }
+    else
+    {
+      logger.err_info("Read epoch={}", epoch);
+    }
+    registered_epochs = true;
+  }
+  // Epochs after the first are trees rebuilt after a failure, or a job restarted with the same unique_id.
+  check_membership = epoch > 0;
 
   uint16_t kid_count;
   uint16_t parent_port;
@@ -227,6 +274,13 @@ void AllReduceSockets::all_reduce_init(VW::io::logger& logger)
     logger.err_info("Read parent_port={}", parent_port);
   }
 
+  // The address peers can reach this node at, needed by the ring and recursive halving algorithms.
+  sockaddr_in local_address;
+  socklen_t local_address_size = sizeof(local_address);
+  if (getsockname(master_sock, reinterpret_cast<sockaddr*>(&local_address), &local_address_size) < 0)
+    THROWERRNO("getsockname");
+  local_ip = local_address.sin_addr.s_addr;
+
   CLOSESOCK(master_sock);
 
   if (parent_ip != static_cast<uint32_t>(-1)) { socks.parent = sock_connect(parent_ip, parent_port, logger); }
@@ -257,6 +311,240 @@ void AllReduceSockets::all_reduce_init(VW::io::logger& logger)
   }
 
   if (kid_count > 0) { CLOSESOCK(sock); }
+
+  if (socks.parent != -1) { configure_socket(socks.parent, true); }
+  for (socket_t child : socks.children)
+  {
+    if (child != -1) { configure_socket(child, true); }
+  }
+
+  socks.peers.assign(total, static_cast<socket_t>(-1));
+  if (algorithm == AllReduceAlgorithm::RecursiveHalving && (total & (total - 1)) != 0)
+  {
+    logger.err_warn("Recursive halving allreduce needs a power of two number of nodes, got {}. Using ring.", total);
+    algorithm = AllReduceAlgorithm::Ring;
+  }
+  if (algorithm != AllReduceAlgorithm::Tree && total > 1) { connect_peers(logger); }
+}
+
+void AllReduceSockets::connect_peers(VW::io::logger& logger)
+{
+  std::vector<size_t> peer_nodes;
+  if (algorithm == AllReduceAlgorithm::Ring)
+  {
+    peer_nodes.push_back((node + 1) % total);
+    if (total > 2) { peer_nodes.push_back((node + total - 1) % total); }
+  }
+  else
+  {
+    for (size_t distance = 1; distance < total; distance *= 2) { peer_nodes.push_back(node ^ distance); }
+  }
+  const auto lower_peers =
+      std::count_if(peer_nodes.begin(), peer_nodes.end(), [this](size_t peer) { return peer < node; });
+
+  socket_t sock = getsock(logger);
+  sockaddr_in address;
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = 0;  // any free port
+  socklen_t address_size = sizeof(address);
+  if (::bind(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) THROWERRNO("bind");
+  if (listen(sock, static_cast<int>(peer_nodes.size())) < 0) THROWERRNO("listen");
+  if (getsockname(sock, reinterpret_cast<sockaddr*>(&address), &address_size) < 0) THROWERRNO("getsockname");
+
+  // Share the listening addresses of all nodes over the spanning tree. Each node fills its own slot, the +1 keeps
+  // the slot distinguishable from the zeros of other nodes.
+  std::vector<uint64_t> addresses(total, 0);
+  addresses[node] = ((static_cast<uint64_t>(local_ip) << 16) | address.sin_port) + 1;
+  reduce<uint64_t, add_uint64>(reinterpret_cast<char*>(addresses.data()), total * sizeof(uint64_t));
+  broadcast(reinterpret_cast<char*>(addresses.data()), total * sizeof(uint64_t));
+
+  // Connect to the peers with a larger id and accept the ones with a smaller id. The listen backlog makes the connects
+  // complete before the matching accept, so the order does not matter.
+  for (size_t peer : peer_nodes)
+  {
+    if (peer < node) { continue; }
+    const uint64_t peer_address = addresses[peer] - 1;
+    socket_t peer_sock = sock_connect(
+        static_cast<uint32_t>(peer_address >> 16), static_cast<int>(peer_address & 0xFFFF), logger);
+    const uint64_t my_node = node;
+    if (send(peer_sock, reinterpret_cast<const char*>(&my_node), sizeof(my_node), ar_send_flags) <
+        static_cast<int>(sizeof(my_node)))
+      THROW("Write node id to peer " << peer << " failed");
+    socks.peers[peer] = peer_sock;
+  }
+  for (int i = 0; i < lower_peers; i++)
+  {
+    sockaddr_in peer_address;
+    socklen_t size = sizeof(peer_address);
+    socket_t peer_sock = accept(sock, reinterpret_cast<sockaddr*>(&peer_address), &size);
+#ifdef _WIN32
+    if (peer_sock == INVALID_SOCKET)
+#else
+    if (peer_sock < 0)
+#endif
+      THROWERRNO("accept");
+
+    uint64_t peer = 0;
+    if (recv(peer_sock, reinterpret_cast<char*>(&peer), sizeof(peer), MSG_WAITALL) < static_cast<int>(sizeof(peer)))
+      THROW("Read node id from peer failed");
+    if (peer >= total || socks.peers[peer] != -1) THROW("Unexpected connection from node " << peer);
+    socks.peers[peer] = peer_sock;
+  }
+  CLOSESOCK(sock);
+
+  // Both ends of a link send at the same time, blocking sends could deadlock once the socket buffers are full.
+  for (size_t peer : peer_nodes)
+  {
+    set_nonblocking(socks.peers[peer]);
+    configure_socket(socks.peers[peer], false);
+  }
+}
+
+void AllReduceSockets::configure_socket(socket_t sock, bool blocking)
+{
+  // Non-blocking sockets are only used through select, which applies the timeout itself.
+  if (blocking && timeout_seconds > 0.f)
+  {
+#ifdef _WIN32
+    DWORD timeout = static_cast<DWORD>(timeout_seconds * 1000);
+#else
+    timeval timeout;
+    select_timeout(timeout);
+#endif
+    if (setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout)) < 0)
+      THROWERRNO("setsockopt SO_RCVTIMEO");
+    if (setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout)) < 0)
+      THROWERRNO("setsockopt SO_SNDTIMEO");
+  }
+
+  if (heartbeat_seconds > 0.f)
+  {
+    int on = 1;
+    if (setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, reinterpret_cast<char*>(&on), sizeof(on)) < 0)
+      THROWERRNO("setsockopt SO_KEEPALIVE");
+#ifdef __linux__
+    // A node is considered dead after three unanswered probes.
+    int interval = std::max(1, static_cast<int>(heartbeat_seconds));
+    int probes = 3;
+    unsigned int user_timeout = static_cast<unsigned int>(interval * probes * 1000);
+    if (setsockopt(sock, IPPROTO_TCP, TCP_KEEPIDLE, &interval, sizeof(interval)) < 0 ||
+        setsockopt(sock, IPPROTO_TCP, TCP_KEEPINTVL, &interval, sizeof(interval)) < 0 ||
+        setsockopt(sock, IPPROTO_TCP, TCP_KEEPCNT, &probes, sizeof(probes)) < 0 ||
+        setsockopt(sock, IPPROTO_TCP, TCP_USER_TIMEOUT, &user_timeout, sizeof(user_timeout)) < 0)
+      THROWERRNO("setsockopt TCP_KEEPIDLE");
+#endif
+  }
+}
+
+void AllReduceSockets::reset_connections()
+{
+  if (socks.parent != -1) { CLOSESOCK(socks.parent); }
+  socks.parent = static_cast<socket_t>(-1);
+  for (socket_t& child : socks.children)
+  {
+    if (child != -1) { CLOSESOCK(child); }
+    child = static_cast<socket_t>(-1);
+  }
+  for (socket_t& peer : socks.peers)
+  {
+    if (peer != -1) { CLOSESOCK(peer); }
+    peer = static_cast<socket_t>(-1);
+  }
+  socks.current_master = "";
+}
+
+AllReduceSockets::~AllReduceSockets()
+{
+  if (!registered_epochs || node != 0 || sync_failed) { return; }
+
+  // Best effort: connect once without retrying, a span server that is gone has nothing to forget.
+  hostent* master = gethostbyname(span_server.c_str());
+  if (master == nullptr) { return; }
+  socket_t sock = socket(PF_INET, SOCK_STREAM, 0);
+  if (sock == static_cast<socket_t>(-1)) { return; }
+  sockaddr_in far_end;
+  memset(&far_end, 0, sizeof(far_end));
+  far_end.sin_family = AF_INET;
+  far_end.sin_port = htons(static_cast<u_short>(port));
+  far_end.sin_addr = *reinterpret_cast<in_addr*>(master->h_addr);
+  if (connect(sock, reinterpret_cast<sockaddr*>(&far_end), sizeof(far_end)) == 0)
+  {
+    const size_t message[3] = {unique_id, total, node | VW::SPAN_JOB_FINISHED};
+    send(sock, reinterpret_cast<const char*>(message), sizeof(message), ar_send_flags);
+  }
+  CLOSESOCK(sock);
+}
+
+void AllReduceSockets::check_rejoin(size_t n, VW::io::logger& logger)
+{
+  check_membership = false;
+
+  // Survivors retry the call that failed, replacements (which start from a saved model) make their first call. Both
+  // must be about to reduce the same buffer, and all survivors must have completed the same number of calls.
+  std::vector<uint64_t> state(2 * total, 0);
+  state[2 * node] = n;
+  state[2 * node + 1] = completed_calls;
+  reduce<uint64_t, add_uint64>(reinterpret_cast<char*>(state.data()), state.size() * sizeof(uint64_t));
+  broadcast(reinterpret_cast<char*>(state.data()), state.size() * sizeof(uint64_t));
+
+  uint64_t survivor_calls = 0;
+  for (size_t i = 0; i < total; i++)
+  {
+    if (state[2 * i] != n)
+    {
+      THROW_EX(VW::allreduce_rejoin_exception,
+          "Node " << i << " rejoined with " << state[2 * i] << " values to sync instead of " << n
+                  << ". Restart all nodes from the last saved model.");
+    }
+    const uint64_t calls = state[2 * i + 1];
+    if (calls == 0) { continue; }
+    if (survivor_calls != 0 && calls != survivor_calls)
+    {
+      THROW_EX(VW::allreduce_rejoin_exception,
+          "Nodes rejoined after " << survivor_calls << " and " << calls
+                                  << " completed syncs. Restart all nodes from the last saved model.");
+    }
+    survivor_calls = calls;
+  }
+  logger.err_info("spanning tree epoch {} agrees on {} completed syncs", epoch, survivor_calls);
+}
+
+void AllReduceSockets::exchange(
+    socket_t send_sock, const char* send_buf, size_t send_size, socket_t recv_sock, char* recv_buf, size_t recv_size)
+{
+  size_t sent = 0;
+  size_t received = 0;
+  while (sent < send_size || received < recv_size)
+  {
+    fd_set read_fds;
+    fd_set write_fds;
+    FD_ZERO(&read_fds);
+    FD_ZERO(&write_fds);
+    if (sent < send_size) FD_SET(send_sock, &write_fds);
+    if (received < recv_size) FD_SET(recv_sock, &read_fds);
+    socket_t max_fd = std::max(send_sock, recv_sock) + 1;
+    timeval timeout;
+    const int ready = select(static_cast<int>(max_fd), &read_fds, &write_fds, nullptr, select_timeout(timeout));
+    if (ready == -1) THROWERRNO("select");
+    if (ready == 0) THROW("Timed out exchanging data with a peer");
+
+    if (sent < send_size && FD_ISSET(send_sock, &write_fds))
+    {
+      int write_size =
+          send(send_sock, send_buf + sent, static_cast<int>(std::min(ar_buf_size, send_size - sent)), ar_send_flags);
+      if (write_size < 0 && !would_block()) THROWERRNO("send to peer");
+      if (write_size > 0) { sent += write_size; }
+    }
+    if (received < recv_size && FD_ISSET(recv_sock, &read_fds))
+    {
+      int read_size =
+          recv(recv_sock, recv_buf + received, static_cast<int>(std::min(ar_buf_size, recv_size - received)), 0);
+      if (read_size == 0) THROW("Peer closed the connection");
+      if (read_size < 0 && !would_block()) THROWERRNO("recv from peer");
+      if (read_size > 0) { received += read_size; }
+    }
+  }
 }
 
 void AllReduceSockets::pass_down(char* buffer, const size_t parent_read_pos, size_t& children_sent_pos)
@@ -267,11 +555,11 @@ void AllReduceSockets::pass_down(char* buffer, const size_t parent_read_pos, siz
   {
     // going to pass up this chunk of data to the children
     if (socks.children[0] != -1 &&
-        send(socks.children[0], buffer + children_sent_pos, static_cast<int>(my_bufsize), 0) <
+        send(socks.children[0], buffer + children_sent_pos, static_cast<int>(my_bufsize), ar_send_flags) <
             static_cast<int>(my_bufsize))
     { THROW("Write to left child failed"); }
     if (socks.children[1] != -1 &&
-        send(socks.children[1], buffer + children_sent_pos, static_cast<int>(my_bufsize), 0) <
+        send(socks.children[1], buffer + children_sent_pos, static_cast<int>(my_bufsize), ar_send_flags) <
             static_cast<int>(my_bufsize))
     { THROW("Write to right child failed"); }
 
@@ -302,6 +590,7 @@ void AllReduceSockets::broadcast(char* buffer, const size_t n)
       size_t count = std::min(ar_buf_size, n - parent_read_pos);
       int read_size = recv(socks.parent, buffer + parent_read_pos, static_cast<int>(count), 0);
       if (read_size == -1) { THROW("recv from parent: " << VW::strerror_to_string(errno)); }
+      if (read_size == 0) THROW("Parent closed the connection");
       parent_read_pos += read_size;
     }
   }
@@ -0,0 +1,220 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "async_averager.h"
+
+#include "allreduce.h"
+#include "global_data.h"
+#include "io/logger.h"
+#include "vw_exception.h"
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+namespace
+{
+void add_delta(float& c1, const float& c2) { c1 += c2; }
+}  // namespace
+
+namespace VW
+{
+struct async_averager::channel
+{
+  std::unique_ptr<AllReduceSockets> connection;
+  VW::io::logger logger;
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool submitted = false;
+  bool ready = false;
+  bool stop = false;
+  bool finished = false;      // the thread returned
+  std::exception_ptr error;   // failure of the communication thread, rethrown on the learning thread
+  std::vector<float> buffer;  // deltas followed by the done flag, summed over the nodes in place
+
+  channel(std::unique_ptr<AllReduceSockets> connection, VW::io::logger logger)
+      : connection(std::move(connection)), logger(std::move(logger))
+  {
+  }
+};
+
+async_averager::async_averager(VW::workspace& all, std::unique_ptr<AllReduceSockets> connection,
+    uint64_t interval_examples, float interval_seconds, float alpha)
+    : _all(all)
+    , _interval_examples(interval_examples)
+    , _interval_seconds(interval_seconds)
+    , _alpha(alpha)
+    , _total(connection->total)
+    , _channel(std::make_shared<channel>(std::move(connection), all.logger))
+{
+  _thread = std::thread(&async_averager::run, _channel);
+}
+
+async_averager::~async_averager()
+{
+  const auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(shutdown_timeout);
+
+  // Nodes that stop without a final end_pass still have to take part in the rounds the others are waiting for.
+  _has_deadline = true;
+  _deadline = deadline;
+  try
+  {
+    if (_in_flight || _pending_rounds) { end_pass(); }
+  }
+  catch (const std::exception& e)
+  {
+    _all.logger.err_error("async averaging failed to finish: {}", e.what());
+  }
+  stop_thread(deadline);
+}
+
+void async_averager::stop_thread(std::chrono::steady_clock::time_point deadline)
+{
+  bool finished;
+  {
+    std::unique_lock<std::mutex> lock(_channel->mutex);
+    _channel->stop = true;
+    _channel->cv.notify_all();
+    finished = _channel->cv.wait_until(lock, deadline, [this] { return _channel->finished; });
+  }
+  if (finished) { _thread.join(); }
+  else
+  {
+    _all.logger.err_error("async averaging is still waiting for another node, leaving its thread behind");
+    _thread.detach();
+  }
+}
+
+// The weights are only allocated once the model is set up, so the reference is taken when learning starts.
+void async_averager::initialize()
+{
+  if (_all.weights.sparse) THROW("--async_averaging does not support --sparse_weights");
+  const size_t length = static_cast<size_t>(1) << _all.num_bits;
+  auto& weights = _all.weights.dense_weights;
+  _reference.resize(length);
+  _delta.resize(length);
+  std::lock_guard<std::mutex> lock(_channel->mutex);
+  _channel->buffer.resize(length + 1);
+  for (size_t i = 0; i < length; i++) { _reference[i] = weights.strided_index(i); }
+  _last_submit = std::chrono::steady_clock::now();
+  _initialized = true;
+}
+
+void async_averager::on_example()
+{
+  if (!_initialized) { initialize(); }
+
+  _examples_since_submit++;
+  if (_in_flight)
+  {
+    bool ready;
+    {
+      std::lock_guard<std::mutex> lock(_channel->mutex);
+      ready = _channel->ready;
+    }
+    if (ready) { wait_and_apply(); }
+    return;
+  }
+
+  if ((_interval_examples > 0 && _examples_since_submit >= _interval_examples) ||
+      (_interval_seconds.count() > 0 && std::chrono::steady_clock::now() - _last_submit >= _interval_seconds))
+  { submit(false); }
+}
+
+void async_averager::end_pass()
+{
+  if (!_initialized) { initialize(); }
+  bool all_done = false;
+  if (_in_flight) { all_done = wait_and_apply(); }
+  while (!all_done)
+  {
+    submit(true);
+    all_done = wait_and_apply();
+  }
+  _pending_rounds = false;
+}
+
+void async_averager::submit(bool done)
+{
+  auto& weights = _all.weights.dense_weights;
+  {
+    std::lock_guard<std::mutex> lock(_channel->mutex);
+    auto& buffer = _channel->buffer;
+    for (size_t i = 0; i < _reference.size(); i++)
+    {
+      _delta[i] = weights.strided_index(i) - _reference[i];
+      buffer[i] = _delta[i];
+    }
+    buffer.back() = done ? 1.f : 0.f;
+    _channel->submitted = true;
+    _channel->ready = false;
+  }
+  _channel->cv.notify_all();
+  _in_flight = true;
+  _pending_rounds = true;
+  _examples_since_submit = 0;
+  _last_submit = std::chrono::steady_clock::now();
+}
+
+// Returns whether every node had reached the end of the pass in the applied round.
+bool async_averager::wait_and_apply()
+{
+  std::unique_lock<std::mutex> lock(_channel->mutex);
+  auto ready = [this] { return _channel->ready; };
+  if (!_has_deadline) { _channel->cv.wait(lock, ready); }
+  else if (!_channel->cv.wait_until(lock, _deadline, ready))
+  {
+    THROW("async averaging round did not finish within " << shutdown_timeout.count() << " seconds");
+  }
+  _channel->ready = false;
+  _in_flight = false;
+  if (_channel->error) { std::rethrow_exception(_channel->error); }
+
+  // Learning went on while the round was in flight. Only the submitted part of the local change is replaced by the
+  // average, everything learned since is kept.
+  auto& weights = _all.weights.dense_weights;
+  const auto& buffer = _channel->buffer;
+  const float inv_total = 1.f / static_cast<float>(_total);
+  for (size_t i = 0; i < _reference.size(); i++)
+  {
+    const float average_delta = buffer[i] * inv_total;
+    weights.strided_index(i) += _alpha * (average_delta - _delta[i]);
+    _reference[i] += average_delta;
+  }
+  return buffer.back() >= static_cast<float>(_total);
+}
+
+void async_averager::run(const std::shared_ptr<channel>& shared)
+{
+  channel& state = *shared;
+  std::unique_lock<std::mutex> lock(state.mutex);
+  while (true)
+  {
+    state.cv.wait(lock, [&state] { return state.stop || state.submitted; });
+    if (state.stop) { break; }
+
+    // buffer is not touched by the learning thread until ready is set.
+    lock.unlock();
+    std::exception_ptr error;
+    try
+    {
+      state.connection->all_reduce<float, add_delta>(state.buffer.data(), state.buffer.size(), state.logger);
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+    lock.lock();
+
+    state.error = error;
+
+    state.submitted = false;
+    state.ready = true;
+    state.cv.notify_all();
+  }
+  state.finished = true;
+  state.cv.notify_all();
+}
+}  // namespace VW
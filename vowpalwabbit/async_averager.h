@@ -0,0 +1,76 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+// Asynchronous model averaging between cluster nodes (--async_averaging). Every interval the learning thread hands
+// the change of its weights since the last averaging to a communication thread, which sums them over all nodes
+// while learning continues. The averaged change is folded back in once it arrives.
+#pragma once
+
+#include "vw_fwd.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class AllReduceSockets;
+
+namespace VW
+{
+class async_averager
+{
+public:
+  // connection must be a span server connection of its own, it is used from the communication thread.
+  async_averager(VW::workspace& all, std::unique_ptr<AllReduceSockets> connection, uint64_t interval_examples,
+      float interval_seconds, float alpha);
+  // Finishes the rounds the other nodes wait for, but gives up after shutdown_timeout. A communication thread that is
+  // still blocked on a dead node then is left behind instead of blocking the destructor.
+  ~async_averager();
+
+  async_averager(const async_averager&) = delete;
+  async_averager& operator=(const async_averager&) = delete;
+
+  // Called on the learning thread before each example is learned.
+  void on_example();
+  // Called on the learning thread at the end of each pass. Keeps averaging until every node reached the end of the
+  // pass, so that the nodes can then synchronize as usual.
+  void end_pass();
+
+  std::chrono::duration<float> shutdown_timeout = std::chrono::seconds(60);
+
+private:
+  // State shared with the communication thread. The thread holds its own reference, so the state outlives an
+  // averager that stopped waiting for it.
+  struct channel;
+
+  void initialize();
+  void submit(bool done);
+  bool wait_and_apply();
+  // Stops the communication thread, waiting at most until deadline for it to return.
+  void stop_thread(std::chrono::steady_clock::time_point deadline);
+  static void run(const std::shared_ptr<channel>& shared);
+
+  VW::workspace& _all;
+  uint64_t _interval_examples;
+  std::chrono::duration<float> _interval_seconds;
+  float _alpha;
+  size_t _total;  // number of nodes
+
+  // Learning thread only.
+  bool _initialized = false;
+  bool _in_flight = false;
+  bool _pending_rounds = false;  // averaged since the last end_pass
+  uint64_t _examples_since_submit = 0;
+  std::chrono::steady_clock::time_point _last_submit;
+  // Set while the destructor finishes the last rounds, waiting for a round fails after _deadline.
+  bool _has_deadline = false;
+  std::chrono::steady_clock::time_point _deadline;
+  std::vector<float> _reference;  // averaged weights all nodes agree on
+  std::vector<float> _delta;      // weights - _reference when the in flight round was submitted
+
+  std::shared_ptr<channel> _channel;
+  std::thread _thread;
+};
+}  // namespace VW
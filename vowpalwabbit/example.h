@@ -34,6 +34,7 @@ namespace VW
 {
 void copy_example_data(example* dst, const example* src);
 void setup_example(VW::workspace& all, example* ae);
+void setup_example_for_predict(VW::workspace& all, example* ae);
 
 struct polylabel
 {
@@ -131,6 +132,7 @@ struct example : public example_predict  // core example datatype.
 
   friend void VW::copy_example_data(example* dst, const example* src);
   friend void VW::setup_example(VW::workspace& all, example* ae);
+  friend void VW::setup_example_for_predict(VW::workspace& all, example* ae);
 
 private:
   bool total_sum_feat_sq_calculated = false;
@@ -289,4 +289,10 @@ void cs_ldf_learn_or_predict(VW::LEARNER::multi_learner& base, VW::multi_ex& exa
     base.predict(examples, static_cast<int32_t>(id));
 }
 
+// cs_ldf_learn_or_predict<false> for the count offsets [lo, lo + count) of base at once, see
+// LEARNER::learner::multipredict. The action scores of offset lo + c are written to pred[c].a_s.
+void cs_ldf_multipredict(VW::LEARNER::multi_learner& base, VW::multi_ex& examples, std::vector<CB::label>& cb_labels,
+    COST_SENSITIVE::label& cs_labels, std::vector<COST_SENSITIVE::label>& prepped_cs_labels, uint64_t offset,
+    size_t lo, size_t count, VW::polyprediction* pred);
+
 }  // namespace GEN_CS
@@ -7,6 +7,7 @@
 #define RAPIDJSON_HAS_STDSTRING 1
 
 #include "array_parameters.h"
+#include "async_averager.h"
 #include "future_compat.h"
 #include "io/logger.h"
 #include "kskip_ngram_transformer.h"
@@ -154,6 +155,7 @@ void workspace::learn(example& ec)
   if (ec.test_only || !training) { VW::LEARNER::as_singleline(l)->predict(ec); }
   else
   {
+    if (async_averager != nullptr) { async_averager->on_example(); }
     if (l->learn_returns_prediction) { VW::LEARNER::as_singleline(l)->learn(ec); }
     else
     {
@@ -170,6 +172,7 @@ void workspace::learn(multi_ex& ec)
   if (!training) { VW::LEARNER::as_multiline(l)->predict(ec); }
   else
   {
+    if (async_averager != nullptr) { async_averager->on_example(); }
     if (l->learn_returns_prediction) { VW::LEARNER::as_multiline(l)->learn(ec); }
     else
     {
@@ -472,6 +475,9 @@ VW_WARNING_STATE_POP
 
 workspace::~workspace()
 {
+  // finishes the outstanding averaging rounds, which needs the weights and the learner
+  async_averager.reset();
+
   if (l != nullptr)
   {
     l->finish();
@@ -9,6 +9,7 @@
 #include "future_compat.h"
 #include "interactions_predict.h"
 #include "io/logger.h"
+#include "perf_counters.h"
 #include "version.h"
 #include "vw_fwd.h"
 #include "vw_string_view.h"
@@ -59,6 +60,10 @@ struct dictionary_info
 
 class AllReduce;
 enum class AllReduceType;
+namespace VW
+{
+class async_averager;
+}
 
 #ifdef BUILD_EXTERNAL_PARSER
 // forward declarations
@@ -120,6 +125,7 @@ public:
 
   AllReduceType all_reduce_type;
   AllReduce* all_reduce;
+  std::unique_ptr<VW::async_averager> async_averager;  // only set with --async_averaging
 
   bool chain_hash_json = false;
 
@@ -186,6 +192,9 @@ public:
   double normalized_sum_norm_x;
   bool vw_is_main = false;  // true if vw is executable; false in library mode
 
+  // hardware counters per driver phase, only set with --perf_counters
+  std::unique_ptr<VW::perf_counters> perf_counters;
+
   // error reporting
   std::shared_ptr<trace_message_wrapper> trace_message_wrapper_context;
   std::unique_ptr<std::ostream> trace_message;
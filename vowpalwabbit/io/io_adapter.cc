@@ -87,6 +87,8 @@ struct file_adapter : public writer, public reader
   ssize_t read(char* buffer, size_t num_bytes) override;
   ssize_t write(const char* buffer, size_t num_bytes) override;
   void reset() override;
+  void seek(uint64_t offset);
+  uint64_t size();
 
 private:
   int _file_descriptor;
@@ -171,6 +173,69 @@ private:
   size_t _len;
 };
 
+// Finds the ends of records in a stream of bytes. A record ends with a newline, or with an empty line when records
+// are separated by blank lines.
+class record_end_detector
+{
+public:
+  explicit record_end_detector(bool blank_line_records) : _blank_line_records(blank_line_records) {}
+
+  bool ends_record(char c)
+  {
+    const bool ends = c == '\n' && (!_blank_line_records || _after_newline);
+    if (c == '\n') { _after_newline = true; }
+    else if (c != '\r')
+    {
+      _after_newline = false;
+    }
+    return ends;
+  }
+
+  // at_record_start: the previous byte ended a record.
+  void reset(bool at_record_start) { _after_newline = at_record_start; }
+
+private:
+  bool _blank_line_records;
+  bool _after_newline = false;
+};
+
+struct file_shard_adapter : public reader
+{
+  file_shard_adapter(const char* filename, size_t shard, size_t num_shards, bool blank_line_records);
+  ~file_shard_adapter() = default;
+  ssize_t read(char* buffer, size_t num_bytes) override;
+  void reset() override;
+
+private:
+  file_adapter _file;
+  record_end_detector _detector;
+  uint64_t _start;     // first byte of the first record of the shard
+  uint64_t _end;       // the shard holds the records starting before this byte
+  uint64_t _position;  // next byte to read
+  bool _done;
+};
+
+struct record_hash_filter : public reader
+{
+  record_hash_filter(std::unique_ptr<reader> inner, size_t shard, size_t num_shards, bool blank_line_records);
+  ~record_hash_filter() = default;
+  ssize_t read(char* buffer, size_t num_bytes) override;
+  void reset() override;
+
+private:
+  void finish_record();
+
+  std::unique_ptr<reader> _inner;
+  size_t _shard;
+  size_t _num_shards;
+  record_end_detector _detector;
+  std::vector<char> _chunk;
+  std::vector<char> _record;    // record being read from _inner
+  std::vector<char> _selected;  // records of this shard not yet returned
+  size_t _selected_position = 0;
+  bool _inner_done = false;
+};
+
 namespace VW
 {
 namespace io
@@ -219,6 +284,18 @@ std::unique_ptr<reader> create_buffer_view(const char* data, size_t len)
 {
   return std::unique_ptr<reader>(new buffer_view(data, len));
 }
+
+std::unique_ptr<reader> open_file_shard_reader(
+    const std::string& file_path, size_t shard, size_t num_shards, bool blank_line_records)
+{
+  return std::unique_ptr<reader>(new file_shard_adapter(file_path.c_str(), shard, num_shards, blank_line_records));
+}
+
+std::unique_ptr<reader> create_record_hash_filter(
+    std::unique_ptr<reader> inner, size_t shard, size_t num_shards, bool blank_line_records)
+{
+  return std::unique_ptr<reader>(new record_hash_filter(std::move(inner), shard, num_shards, blank_line_records));
+}
 }  // namespace io
 }  // namespace VW
 
@@ -327,15 +404,29 @@ ssize_t file_adapter::write(const char* buffer, size_t num_bytes)
 #endif
 }
 
-void file_adapter::reset()
+void file_adapter::reset() { seek(0); }
+
+void file_adapter::seek(uint64_t offset)
 {
 #ifdef _WIN32
-  ::_lseek(_file_descriptor, 0, SEEK_SET);
+  ::_lseeki64(_file_descriptor, static_cast<int64_t>(offset), SEEK_SET);
 #else
-  ::lseek(_file_descriptor, 0, SEEK_SET);
+  ::lseek(_file_descriptor, static_cast<off_t>(offset), SEEK_SET);
 #endif
 }
 
+uint64_t file_adapter::size()
+{
+#ifdef _WIN32
+  struct _stat64 stats;
+  if (::_fstat64(_file_descriptor, &stats) != 0) { THROWERRNO("fstat"); }
+#else
+  struct stat stats;
+  if (::fstat(_file_descriptor, &stats) != 0) { THROWERRNO("fstat"); }
+#endif
+  return static_cast<uint64_t>(stats.st_size);
+}
+
 file_adapter::~file_adapter()
 {
   if (_should_close)
@@ -462,3 +553,147 @@ ssize_t buffer_view::read(char* buffer, size_t num_bytes)
   return num_bytes;
 }
 void buffer_view::reset() { _read_head = _data; }
+
+//
+// file_shard_adapter
+//
+
+namespace
+{
+// First byte of shard out of num_shards equal parts of size bytes, without overflowing for large files.
+uint64_t shard_boundary(uint64_t size, size_t shard, size_t num_shards)
+{
+  return size / num_shards * shard + size % num_shards * shard / num_shards;
+}
+}  // namespace
+
+file_shard_adapter::file_shard_adapter(const char* filename, size_t shard, size_t num_shards, bool blank_line_records)
+    : reader(true /*is_resettable*/), _file(filename, file_mode::read), _detector(blank_line_records)
+{
+  if (shard >= num_shards) { THROW("Shard " << shard << " out of range for " << num_shards << " shards"); }
+  const uint64_t size = _file.size();
+  const uint64_t begin = shard_boundary(size, shard, num_shards);
+  _end = shard_boundary(size, shard + 1, num_shards);
+
+  // A record belongs to the shard its first byte falls into. Only the record crossing begin is read to find the
+  // first one of this shard, starting a few bytes early so that blank lines just before begin are recognized.
+  _start = begin == 0 ? 0 : size;
+  if (begin > 0)
+  {
+    const uint64_t scan_from = begin >= 3 ? begin - 3 : 0;
+    _file.seek(scan_from);
+    _detector.reset(false);
+    char buffer[4096];
+    uint64_t position = scan_from;
+    ssize_t num_read;
+    while (_start == size && (num_read = _file.read(buffer, sizeof(buffer))) > 0)
+    {
+      for (ssize_t i = 0; i < num_read; i++, position++)
+      {
+        if (_detector.ends_record(buffer[i]) && position + 1 >= begin)
+        {
+          _start = position + 1;
+          break;
+        }
+      }
+    }
+  }
+  reset();
+}
+
+ssize_t file_shard_adapter::read(char* buffer, size_t num_bytes)
+{
+  if (_done) { return 0; }
+  const ssize_t num_read = _file.read(buffer, num_bytes);
+  if (num_read <= 0) { return num_read; }
+
+  // The shard ends with the record holding byte _end - 1.
+  for (ssize_t i = 0; i < num_read; i++)
+  {
+    if (_detector.ends_record(buffer[i]) && _position + i + 1 >= _end)
+    {
+      _done = true;
+      _position += i + 1;
+      return i + 1;
+    }
+  }
+  _position += num_read;
+  return num_read;
+}
+
+void file_shard_adapter::reset()
+{
+  _file.seek(_start);
+  _position = _start;
+  _detector.reset(true);
+  _done = _start >= _end;
+}
+
+//
+// record_hash_filter
+//
+
+record_hash_filter::record_hash_filter(
+    std::unique_ptr<reader> inner, size_t shard, size_t num_shards, bool blank_line_records)
+    : reader(inner->is_resettable())
+    , _inner(std::move(inner))
+    , _shard(shard)
+    , _num_shards(num_shards)
+    , _detector(blank_line_records)
+    , _chunk(1 << 16)
+{
+  if (shard >= num_shards) { THROW("Shard " << shard << " out of range for " << num_shards << " shards"); }
+  _detector.reset(true);
+}
+
+ssize_t record_hash_filter::read(char* buffer, size_t num_bytes)
+{
+  while (_selected_position == _selected.size() && !_inner_done)
+  {
+    _selected.clear();
+    _selected_position = 0;
+    const ssize_t num_read = _inner->read(_chunk.data(), _chunk.size());
+    if (num_read < 0) { return num_read; }
+    if (num_read == 0)
+    {
+      // The last record may not end with a newline.
+      _inner_done = true;
+      finish_record();
+      break;
+    }
+    for (ssize_t i = 0; i < num_read; i++)
+    {
+      _record.push_back(_chunk[i]);
+      if (_detector.ends_record(_chunk[i])) { finish_record(); }
+    }
+  }
+
+  const size_t num_copied = std::min(num_bytes, _selected.size() - _selected_position);
+  std::memcpy(buffer, _selected.data() + _selected_position, num_copied);
+  _selected_position += num_copied;
+  return static_cast<ssize_t>(num_copied);
+}
+
+void record_hash_filter::finish_record()
+{
+  if (_record.empty()) { return; }
+  // FNV-1a, so that every node agrees on the split independent of platform and build.
+  uint64_t hash = 14695981039346656037ULL;
+  for (char c : _record)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  if (hash % _num_shards == _shard) { _selected.insert(_selected.end(), _record.begin(), _record.end()); }
+  _record.clear();
+}
+
+void record_hash_filter::reset()
+{
+  _inner->reset();
+  _detector.reset(true);
+  _record.clear();
+  _selected.clear();
+  _selected_position = 0;
+  _inner_done = false;
+}
@@ -121,5 +121,17 @@ std::unique_ptr<writer> create_vector_writer(std::shared_ptr<std::vector<char>>&
 /// \param len length of buffer
 std::unique_ptr<reader> create_buffer_view(const char* data, size_t len);
 
+/// Reads the records of a text file whose first byte falls into byte range shard out of num_shards equal ranges, so
+/// that the shards of all nodes together hold every record exactly once. Records end with a newline, or with an empty
+/// line if blank_line_records is set (multiline examples). The range is found by seeking, only the record crossing
+/// its start is read beyond it.
+std::unique_ptr<reader> open_file_shard_reader(
+    const std::string& file_path, size_t shard, size_t num_shards, bool blank_line_records);
+
+/// Passes on the records of inner, delimited as for open_file_shard_reader, whose hash modulo num_shards is shard.
+/// Works for any input but every node reads all of it.
+std::unique_ptr<reader> create_record_hash_filter(
+    std::unique_ptr<reader> inner, size_t shard, size_t num_shards, bool blank_line_records);
+
 }  // namespace io
 }  // namespace VW
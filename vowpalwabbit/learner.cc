@@ -16,13 +16,17 @@ namespace LEARNER
 {
 void learn_ex(example& ec, VW::workspace& all)
 {
+  VW::perf_phase_scope perf_scope(all.perf_counters.get(), VW::perf_phase::learn, true);
   all.learn(ec);
+  perf_scope.switch_to(VW::perf_phase::output);
   as_singleline(all.l)->finish_example(all, ec);
 }
 
 void learn_multi_ex(multi_ex& ec_seq, VW::workspace& all)
 {
+  VW::perf_phase_scope perf_scope(all.perf_counters.get(), VW::perf_phase::learn, true);
   all.learn(ec_seq);
+  perf_scope.switch_to(VW::perf_phase::output);
   as_multiline(all.l)->finish_example(all, ec_seq);
 }
 
@@ -305,7 +309,11 @@ void generic_driver_onethread(VW::workspace& all)
     examples_queue.reset_examples(&examples);
     process_examples(examples_queue, handler);
   };
-  parse_dispatch(all, multi_ex_fptr);
+  {
+    // Examples are learned from inside parse_dispatch, their scopes take those counts out of the parse phase.
+    VW::perf_phase_scope perf_scope(all.perf_counters.get(), VW::perf_phase::parse);
+    parse_dispatch(all, multi_ex_fptr);
+  }
   handler.process_remaining();
   all.l->end_examples();
 }
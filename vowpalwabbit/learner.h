@@ -30,9 +30,21 @@
 #include "future_compat.h"
 #include "label_type.h"
 #include "metric_sink.h"
+#ifdef VW_LEARNER_PROFILING
+#  include "learner_profile.h"
+#endif
 #include "prediction_type.h"
 #include "scope_exit.h"
 
+// Times the enclosing learner call when profiling is compiled in, expands to nothing otherwise.
+#ifdef VW_LEARNER_PROFILING
+#  define VW_PROFILE_LEARNER_CALL(call)              \
+    VW::LEARNER::profile_scope profile_scope_##call( \
+        _profile[VW::LEARNER::profiled_call::call], VW::LEARNER::profiled_examples(ec))
+#else
+#  define VW_PROFILE_LEARNER_CALL(call)
+#endif
+
 namespace VW
 {
 /// \brief Contains the VW::LEARNER::learner object and utilities for
@@ -182,6 +194,24 @@ inline void decrement_offset(multi_ex& ec_seq, const size_t increment, const siz
   debug_decrement_depth(ec_seq);
 }
 
+// Used by the default multipredict of a learner that does not implement it, after each offset was predicted.
+inline void save_multipredict_result(example& ec, polyprediction& pred, bool finalize_predictions)
+{
+  if (finalize_predictions)
+    pred = std::move(ec.pred);  // TODO: this breaks for complex labels because = doesn't do deep copy! (XXX we
+                                // "fix" this by moving)
+  else
+    pred.scalar = ec.partial_prediction;
+  // pred.scalar = finalize_prediction ec.partial_prediction; // TODO: this breaks for complex labels because =
+  // doesn't do deep copy! // note works if ec.partial_prediction, but only if finalize_prediction is run????
+}
+
+// The action scores stay on the first example, since callers expect a prediction there after a predict.
+inline void save_multipredict_result(multi_ex& ec_seq, polyprediction& pred, bool /* finalize_predictions */)
+{
+  pred.a_s = ec_seq[0]->pred.a_s;
+}
+
 bool ec_is_example_header(example const& ec, label_type_t label_type);
 
 /// \brief Defines the interface for a learning algorithm.
@@ -236,6 +266,9 @@ private:
   bool _is_multiline;  // Is this a single-line or multi-line reduction?
 
   std::shared_ptr<void> learner_data;
+#ifdef VW_LEARNER_PROFILING
+  learner_profile _profile;
+#endif
 
   learner() = default;  // Should only be able to construct a learner through make_reduction_learner / make_base_learner
 
@@ -276,6 +309,7 @@ public:
   {
     assert((is_multiline() && std::is_same<multi_ex, E>::value) ||
         (!is_multiline() && std::is_same<example, E>::value));  // sanity check under debug compile
+    VW_PROFILE_LEARNER_CALL(learn);
     increment_offset(ec, increment, i);
     debug_log_message(ec, "learn");
     learn_fd.learn_f(learn_fd.data, *learn_fd.base, (void*)&ec);
@@ -295,6 +329,7 @@ public:
   {
     assert((is_multiline() && std::is_same<multi_ex, E>::value) ||
         (!is_multiline() && std::is_same<example, E>::value));  // sanity check under debug compile
+    VW_PROFILE_LEARNER_CALL(predict);
     increment_offset(ec, increment, i);
     debug_log_message(ec, "predict");
     learn_fd.predict_f(learn_fd.data, *learn_fd.base, (void*)&ec);
@@ -305,6 +340,7 @@ public:
   {
     assert((is_multiline() && std::is_same<multi_ex, E>::value) ||
         (!is_multiline() && std::is_same<example, E>::value));  // sanity check under debug compile
+    VW_PROFILE_LEARNER_CALL(multipredict);
     if (learn_fd.multipredict_f == nullptr)
     {
       increment_offset(ec, increment, lo);
@@ -312,13 +348,7 @@ public:
       for (size_t c = 0; c < count; c++)
       {
         learn_fd.predict_f(learn_fd.data, *learn_fd.base, (void*)&ec);
-        if (finalize_predictions)
-          pred[c] = std::move(ec.pred);  // TODO: this breaks for complex labels because = doesn't do deep copy! (XXX we
-                                         // "fix" this by moving)
-        else
-          pred[c].scalar = ec.partial_prediction;
-        // pred[c].scalar = finalize_prediction ec.partial_prediction; // TODO: this breaks for complex labels because =
-        // doesn't do deep copy! // note works if ec.partial_prediction, but only if finalize_prediction is run????
+        save_multipredict_result(ec, pred[c], finalize_predictions);
         increment_offset(ec, increment, 1);
       }
       decrement_offset(ec, increment, lo + count);
@@ -336,6 +366,7 @@ public:
   {
     assert((is_multiline() && std::is_same<multi_ex, E>::value) ||
         (!is_multiline() && std::is_same<example, E>::value));  // sanity check under debug compile
+    VW_PROFILE_LEARNER_CALL(update);
     increment_offset(ec, increment, i);
     debug_log_message(ec, "update");
     learn_fd.update_f(learn_fd.data, *learn_fd.base, (void*)&ec);
@@ -403,6 +434,7 @@ public:
   // called after learn example for each example.  Explicitly not recursive.
   inline void finish_example(VW::workspace& all, E& ec)
   {
+    VW_PROFILE_LEARNER_CALL(finish_example);
     debug_log_message(ec, "finish_example");
     finish_example_fd.finish_example_f(all, finish_example_fd.data, (void*)&ec);
   }
@@ -417,6 +449,23 @@ public:
     finish_example_fd.print_example_f(all, finish_example_fd.data, (void*)&ec);
   }
 
+#ifdef VW_LEARNER_PROFILING
+  // Adds the call counts and timings of this learner and all of its bases to metrics. Returns the depth of this
+  // learner in the stack, the bottom learner being at depth 0.
+  size_t persist_profile(metric_sink& metrics) const
+  {
+    const size_t depth = learn_fd.base != nullptr ? learn_fd.base->persist_profile(metrics) + 1 : 0;
+    _profile.persist(fmt::format("profile.{}.{}", depth, name), metrics);
+    return depth;
+  }
+
+  void print_profile(std::ostream& out) const
+  {
+    if (learn_fd.base != nullptr) { learn_fd.base->print_profile(out); }
+    _profile.print(name, out);
+  }
+#endif
+
   void get_enabled_reductions(std::vector<std::string>& enabled_reductions) const
   {
     if (learn_fd.base) { learn_fd.base->get_enabled_reductions(enabled_reductions); }
@@ -442,6 +491,7 @@ public:
   bool is_multiline() const { return _is_multiline; }
   const std::string& get_name() const { return name; }
   const base_learner* get_learn_base() const { return learn_fd.base; }
+  base_learner* get_learn_base() { return learn_fd.base; }
 };
 
 template <class T, class E>
@@ -488,6 +538,27 @@ void multiline_learn_or_predict(multi_learner& base, multi_ex& examples, const u
     base.predict(examples, id);
 }
 
+// Predicts examples with the count offsets [lo, lo + count) of base, all examples starting from offset. The action
+// scores of offset lo + c are written to pred[c].a_s.
+inline void multiline_multipredict(
+    multi_learner& base, multi_ex& examples, const uint64_t offset, size_t lo, size_t count, polyprediction* pred)
+{
+  std::vector<uint64_t> saved_offsets;
+  saved_offsets.reserve(examples.size());
+  for (auto ec : examples)
+  {
+    saved_offsets.push_back(ec->ft_offset);
+    ec->ft_offset = offset;
+  }
+
+  // Guard example state restore against throws
+  auto restore_guard = VW::scope_exit([&saved_offsets, &examples] {
+    for (size_t i = 0; i < examples.size(); i++) { examples[i]->ft_offset = saved_offsets[i]; }
+  });
+
+  base.multipredict(examples, lo, count, pred, false);
+}
+
 VW_WARNING_STATE_PUSH
 VW_WARNING_DISABLE_CAST_FUNC_TYPE
 template <class FluentBuilderT, class DataT, class ExampleT, class BaseLearnerT>
@@ -0,0 +1,150 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+#pragma once
+
+// Per-learner call counts and timings. Only used when VW is compiled with VW_LEARNER_PROFILING
+// (cmake -DVW_LEARNER_PROFILING=ON), otherwise learner.h does not reference anything in here.
+
+#include "fmt/format.h"
+#include "metric_sink.h"
+#include "vw_fwd.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace VW
+{
+namespace LEARNER
+{
+enum class profiled_call : size_t
+{
+  learn = 0,
+  predict,
+  multipredict,
+  update,
+  finish_example,
+  count  // must be last
+};
+
+inline const char* to_string(profiled_call call)
+{
+  switch (call)
+  {
+    case profiled_call::learn:
+      return "learn";
+    case profiled_call::predict:
+      return "predict";
+    case profiled_call::multipredict:
+      return "multipredict";
+    case profiled_call::update:
+      return "update";
+    case profiled_call::finish_example:
+      return "finish_example";
+    default:
+      return "unknown";
+  }
+}
+
+struct call_stats
+{
+  uint64_t calls = 0;
+  uint64_t examples = 0;  // a call on a multi_ex counts each of its examples
+  uint64_t total_ns = 0;  // time spent in the call, including the base learners it called
+  uint64_t self_ns = 0;   // time spent in the call, excluding the base learners it called
+};
+
+inline uint64_t profiled_examples(const VW::example&) { return 1; }
+inline uint64_t profiled_examples(const VW::multi_ex& ec_seq) { return ec_seq.size(); }
+
+// Time accumulated by the calls made from inside the currently running profiled call on this thread.
+inline uint64_t*& current_child_ns()
+{
+  static thread_local uint64_t* child_ns = nullptr;
+  return child_ns;
+}
+
+class profile_scope
+{
+public:
+  profile_scope(call_stats& stats, uint64_t examples)
+      : _stats(stats)
+      , _examples(examples)
+      , _parent_child_ns(current_child_ns())
+      , _start(std::chrono::steady_clock::now())
+  {
+    current_child_ns() = &_child_ns;
+  }
+
+  ~profile_scope()
+  {
+    const auto elapsed = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count());
+    _stats.calls++;
+    _stats.examples += _examples;
+    _stats.total_ns += elapsed;
+    _stats.self_ns += elapsed > _child_ns ? elapsed - _child_ns : 0;
+    current_child_ns() = _parent_child_ns;
+    if (_parent_child_ns != nullptr) { *_parent_child_ns += elapsed; }
+  }
+
+  profile_scope(const profile_scope&) = delete;
+  profile_scope& operator=(const profile_scope&) = delete;
+
+private:
+  call_stats& _stats;
+  uint64_t _examples;
+  uint64_t* _parent_child_ns;
+  uint64_t _child_ns = 0;
+  std::chrono::steady_clock::time_point _start;
+};
+
+// Calls and examples per second of the time spent in the call, including the base learners.
+inline double per_second(uint64_t count, uint64_t ns) { return ns > 0 ? count * 1e9 / ns : 0.; }
+
+inline void print_profile_header(std::ostream& out)
+{
+  out << fmt::format("{:<30}{:<16}{:>14}{:>14}{:>14}{:>14}{:>16}{:>16}\n", "learner", "call", "count", "examples",
+      "total ms", "self ms", "calls/sec", "examples/sec");
+}
+
+struct learner_profile
+{
+  std::array<call_stats, static_cast<size_t>(profiled_call::count)> stats;
+
+  call_stats& operator[](profiled_call call) { return stats[static_cast<size_t>(call)]; }
+
+  // Keys are of the form profile.<depth>.<learner name>.<call>.<stat>, depth 0 being the bottom of the stack.
+  void persist(const std::string& prefix, metric_sink& metrics) const
+  {
+    for (size_t i = 0; i < stats.size(); i++)
+    {
+      const auto& s = stats[i];
+      if (s.calls == 0) { continue; }
+      const auto key = prefix + "." + to_string(static_cast<profiled_call>(i));
+      metrics.set_uint(key + ".calls", s.calls);
+      metrics.set_uint(key + ".examples", s.examples);
+      metrics.set_float(key + ".total_ms", static_cast<float>(s.total_ns / 1e6));
+      metrics.set_float(key + ".self_ms", static_cast<float>(s.self_ns / 1e6));
+      metrics.set_float(key + ".calls_per_sec", static_cast<float>(per_second(s.calls, s.total_ns)));
+      metrics.set_float(key + ".examples_per_sec", static_cast<float>(per_second(s.examples, s.total_ns)));
+    }
+  }
+
+  void print(const std::string& name, std::ostream& out) const
+  {
+    for (size_t i = 0; i < stats.size(); i++)
+    {
+      const auto& s = stats[i];
+      if (s.calls == 0) { continue; }
+      out << fmt::format("{:<30}{:<16}{:>14}{:>14}{:>14.3f}{:>14.3f}{:>16.1f}{:>16.1f}\n", name,
+          to_string(static_cast<profiled_call>(i)), s.calls, s.examples, s.total_ns / 1e6, s.self_ns / 1e6,
+          per_second(s.calls, s.total_ns), per_second(s.examples, s.total_ns));
+    }
+  }
+};
+}  // namespace LEARNER
+}  // namespace VW
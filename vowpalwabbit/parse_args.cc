@@ -5,6 +5,7 @@
 #include "parse_args.h"
 
 #include "accumulate.h"
+#include "async_averager.h"
 #include "best_constant.h"
 #include "config/cli_help_formatter.h"
 #include "config/cli_options_serializer.h"
@@ -300,6 +301,8 @@ void parse_diagnostics(options_i& options, VW::workspace& all)
   bool version_arg = false;
   bool help = false;
   bool skip_driver = false;
+  bool perf_counters = false;
+  uint64_t perf_counters_interval = 64;
   std::string progress_arg;
   option_group_definition diagnostic_group("Diagnostic");
   diagnostic_group.add(make_option("version", version_arg).help("Version information"))
@@ -309,6 +312,13 @@ void parse_diagnostics(options_i& options, VW::workspace& all)
                .help("Progress update frequency. int: additive, float: multiplicative"))
       .add(make_option("dry_run", skip_driver)
                .help("Parse arguments and print corresponding metadata. Will not execute driver"))
+      .add(make_option("perf_counters", perf_counters)
+               .help("Count cpu cycles, instructions, LLC and dTLB misses of the parse, learn and output phases using "
+                     "Linux perf_event_open. Reported in the summary and in --extra_metrics"))
+      .add(make_option("perf_counters_interval", perf_counters_interval)
+               .default_value(64)
+               .help("With --perf_counters, measure the learn and output phases of one in this many examples and "
+                     "extrapolate. 1 measures every example at the cost of a few system calls each"))
       .add(make_option("help", help)
                .short_name("h")
                .help("More information on vowpal wabbit can be found here https://vowpalwabbit.org"));
@@ -328,6 +338,9 @@ void parse_diagnostics(options_i& options, VW::workspace& all)
   // pass all.quiet around
   if (all.all_reduce) { all.all_reduce->quiet = all.quiet; }
 
+  if (perf_counters)
+  { all.perf_counters = VW::make_unique<VW::perf_counters>(all.logger, perf_counters_interval); }
+
   // Upon direct query for version -- spit it out directly to stdout
   if (version_arg)
   {
@@ -404,7 +417,13 @@ input_options parse_source(VW::workspace& all, options_i& options)
                .help("Enable chain hash in JSON for feature name and string feature value. e.g. {'A': {'B': 'C'}} is "
                      "hashed as A^B^C."))
       .add(make_option("flatbuffer", parsed_options.flatbuffer)
-               .help("Data file will be interpreted as a flatbuffer file"));
+               .help("Data file will be interpreted as a flatbuffer file"))
+      .add(make_option("shard_by", parsed_options.shard_by)
+               .default_value("none")
+               .one_of({"none", "range", "hash"})
+               .help("Read only the part of the data file of --node out of --total nodes. range: the examples "
+                     "starting in an equal byte range of the file, found by seeking. hash: the examples whose text "
+                     "hashes to the node, every node reads the whole input"));
 #ifdef BUILD_EXTERNAL_PARSER
   VW::external::parser::set_parse_args(input_options, parsed_options);
 #endif
@@ -433,8 +452,28 @@ input_options parse_source(VW::workspace& all, options_i& options)
     all.numpasses = static_cast<size_t>(1e5);
   }
 
-  // Add an implicit cache file based on the data filename.
-  if (parsed_options.cache) { parsed_options.cache_files.push_back(all.data_filename + ".cache"); }
+  if (parsed_options.shard_by != "none")
+  {
+    if (!options.was_supplied("total")) THROW("--shard_by requires --total, --node and --unique_id");
+    parsed_options.num_shards = VW::cast_to_smaller_type<size_t>(options.get_typed_option<uint64_t>("total").value());
+    parsed_options.shard = VW::cast_to_smaller_type<size_t>(options.get_typed_option<uint64_t>("node").value());
+    if (options.was_supplied("cache_file"))
+    { all.logger.err_warn("--cache_file is read as is, only the data file is split by --shard_by"); }
+  }
+
+  // Add an implicit cache file based on the data filename. Every shard caches its own part of the data.
+  if (parsed_options.cache)
+  {
+    if (parsed_options.num_shards > 1)
+    {
+      parsed_options.cache_files.push_back(
+          fmt::format("{}.shard{}of{}.cache", all.data_filename, parsed_options.shard, parsed_options.num_shards));
+    }
+    else
+    {
+      parsed_options.cache_files.push_back(all.data_filename + ".cache");
+    }
+  }
 
   if ((parsed_options.cache || options.was_supplied("cache_file")) && options.was_supplied("invert_hash"))
     THROW("invert_hash is incompatible with a cache file.  Use it in single pass mode only.")
@@ -1442,6 +1481,16 @@ std::unique_ptr<VW::workspace> parse_args(std::unique_ptr<options_i, options_del
   uint64_t unique_id_arg;
   uint64_t total_arg;
   uint64_t node_arg;
+  std::string all_reduce_algorithm_arg;
+  float all_reduce_sparse_density_arg;
+  std::string all_reduce_quantize_arg;
+  float all_reduce_timeout_arg;
+  float all_reduce_heartbeat_arg;
+  uint64_t all_reduce_retries_arg;
+  uint64_t nodes_per_host_arg;
+  uint64_t async_averaging_arg;
+  float async_averaging_seconds_arg;
+  float async_averaging_alpha_arg;
   option_group_definition parallelization_args("Parallelization");
   parallelization_args
       .add(make_option("span_server", span_server_arg).help("Location of server for setting up spanning tree"))
@@ -1451,7 +1500,53 @@ std::unique_ptr<VW::workspace> parse_args(std::unique_ptr<options_i, options_del
       .add(make_option("node", node_arg).default_value(0).help("Node number in cluster parallel job"))
       .add(make_option("span_server_port", span_server_port_arg)
                .default_value(26543)
-               .help("Port of the server for setting up spanning tree"));
+               .help("Port of the server for setting up spanning tree"))
+      .add(make_option("nodes_per_host", nodes_per_host_arg)
+               .default_value(1)
+               .help("Number of nodes running on each host. Nodes of a host sync through shared memory, nodes h * "
+                     "arg to h * arg + arg - 1 share host h. With more than one host the hosts sync through "
+                     "--span_server"))
+      .add(make_option("allreduce_algorithm", all_reduce_algorithm_arg)
+               .default_value("tree")
+               .one_of({"tree", "ring", "halving"})
+               .help("How nodes sync with --span_server. tree: through the root of the spanning tree. ring: ring "
+                     "reduce-scatter and allgather. halving: recursive halving and doubling, power of two --total"))
+      .add(make_option("allreduce_sparse_density", all_reduce_sparse_density_arg)
+               .default_value(0.f)
+               .help("Sync weights and gradients as index/value pairs while the nonzeros of all nodes together are "
+                     "fewer than this fraction of the weights. 0 always syncs the full weight array"))
+      .add(make_option("allreduce_quantize", all_reduce_quantize_arg)
+               .default_value("none")
+               .one_of({"none", "bf16", "int8"})
+               .help("Encoding of synced weights and gradients, with error feedback. int8 only applies to sparse syncs, "
+                     "full syncs use bf16 instead. Error feedback keeps a float residual per synced buffer, up to one "
+                     "extra copy of the weights"))
+      .add(make_option("allreduce_timeout", all_reduce_timeout_arg)
+               .default_value(0.f)
+               .help("Fail a sync when no data arrives from another node for this many seconds. Must exceed the "
+                     "difference in running time between nodes. 0 waits indefinitely, so --allreduce_retries only "
+                     "recovers from nodes whose connections close"))
+      .add(make_option("allreduce_heartbeat", all_reduce_heartbeat_arg)
+               .default_value(0.f)
+               .help("Probe the connections to the other nodes every this many seconds, a node that misses three "
+                     "probes is considered dead. 0 keeps the system keepalive settings"))
+      .add(make_option("allreduce_retries", all_reduce_retries_arg)
+               .default_value(0)
+               .help("Number of times a failed sync rebuilds the spanning tree at --span_server and starts over. A "
+                     "node that hangs is only detected with --allreduce_timeout, without it the other nodes wait for "
+                     "it forever. A replacement node started with -i <last synced model> and the same --node joins "
+                     "the new tree. Requires a span server that supports retries"))
+      .add(make_option("async_averaging", async_averaging_arg)
+               .default_value(0)
+               .help("Average the weights of all nodes in the background every this many examples while learning "
+                     "continues. Uses a second connection to --span_server. 0 only syncs at the end of a pass"))
+      .add(make_option("async_averaging_seconds", async_averaging_seconds_arg)
+               .default_value(0.f)
+               .help("Also start a background averaging round when this many seconds passed since the last one"))
+      .add(make_option("async_averaging_alpha", async_averaging_alpha_arg)
+               .default_value(1.f)
+               .help("Fraction of the difference to the average applied to the local weights by a background round. "
+                     "1 moves to the average, smaller values give elastic averaging"));
   all->options->add_and_parse(parallelization_args);
 
   // total, unique_id and node must be specified together.
@@ -1461,12 +1556,74 @@ std::unique_ptr<VW::workspace> parse_args(std::unique_ptr<options_i, options_del
           all->options->was_supplied("unique_id")))
   { THROW("unique_id, total, and node must be all be specified if any are specified.") }
 
-  if (all->options->was_supplied("span_server"))
+  auto all_reduce_algorithm = AllReduceAlgorithm::Tree;
+  if (all_reduce_algorithm_arg == "ring") { all_reduce_algorithm = AllReduceAlgorithm::Ring; }
+  else if (all_reduce_algorithm_arg == "halving")
+  {
+    all_reduce_algorithm = AllReduceAlgorithm::RecursiveHalving;
+  }
+  const auto make_sockets = [&](uint64_t unique_id, uint64_t total, uint64_t node) {
+    auto sockets = VW::make_unique<AllReduceSockets>(span_server_arg,
+        VW::cast_to_smaller_type<int>(span_server_port_arg), VW::cast_to_smaller_type<size_t>(unique_id),
+        VW::cast_to_smaller_type<size_t>(total), VW::cast_to_smaller_type<size_t>(node), all->quiet,
+        all_reduce_algorithm);
+    sockets->timeout_seconds = all_reduce_timeout_arg;
+    sockets->heartbeat_seconds = all_reduce_heartbeat_arg;
+    return sockets;
+  };
+
+  if (nodes_per_host_arg > 1)
+  {
+    if (!all->options->was_supplied("total")) THROW("--nodes_per_host requires --total, --node and --unique_id");
+    if (total_arg % nodes_per_host_arg != 0)
+      THROW("--total " << total_arg << " is not a multiple of --nodes_per_host " << nodes_per_host_arg);
+    const uint64_t hosts = total_arg / nodes_per_host_arg;
+    const uint64_t host = node_arg / nodes_per_host_arg;
+    const uint64_t local_node = node_arg % nodes_per_host_arg;
+    if (hosts > 1 && !all->options->was_supplied("span_server"))
+      THROW("--nodes_per_host with more than one host requires --span_server");
+
+    // Only the first node of each host talks to the other hosts.
+    std::unique_ptr<AllReduceSockets> host_connection;
+    if (hosts > 1 && local_node == 0)
+    {
+      host_connection = make_sockets(unique_id_arg, hosts, host);
+      host_connection->max_retries = VW::cast_to_smaller_type<size_t>(all_reduce_retries_arg);
+    }
+    all->all_reduce_type = AllReduceType::SharedMemory;
+    all->all_reduce = new AllReduceSharedMemory(fmt::format("/vw_allreduce_{}_{}", unique_id_arg, host),
+        VW::cast_to_smaller_type<size_t>(nodes_per_host_arg), VW::cast_to_smaller_type<size_t>(local_node),
+        std::move(host_connection), VW::cast_to_smaller_type<size_t>(total_arg),
+        VW::cast_to_smaller_type<size_t>(node_arg), all->quiet);
+  }
+  else if (all->options->was_supplied("span_server"))
   {
+    auto sockets = make_sockets(unique_id_arg, total_arg, node_arg);
+    sockets->max_retries = VW::cast_to_smaller_type<size_t>(all_reduce_retries_arg);
     all->all_reduce_type = AllReduceType::Socket;
-    all->all_reduce = new AllReduceSockets(span_server_arg, VW::cast_to_smaller_type<int>(span_server_port_arg),
-        VW::cast_to_smaller_type<size_t>(unique_id_arg), VW::cast_to_smaller_type<size_t>(total_arg),
-        VW::cast_to_smaller_type<size_t>(node_arg), all->quiet);
+    all->all_reduce = sockets.release();
+  }
+
+  if (all->all_reduce != nullptr)
+  {
+    all->all_reduce->sparse_density = all_reduce_sparse_density_arg;
+    if (all_reduce_quantize_arg == "bf16") { all->all_reduce->quantization = AllReduceQuantization::BFloat16; }
+    else if (all_reduce_quantize_arg == "int8")
+    {
+      all->all_reduce->quantization = AllReduceQuantization::Int8;
+    }
+  }
+
+  if (async_averaging_arg > 0 || async_averaging_seconds_arg > 0.f)
+  {
+    if (!all->options->was_supplied("span_server")) THROW("--async_averaging requires --span_server");
+    // The background rounds run over a tree of their own, registered at the span server under a derived id.
+    constexpr uint64_t ASYNC_ID_BIT = UINT64_ONE << 63;
+    if ((unique_id_arg & ASYNC_ID_BIT) != 0) THROW("--async_averaging requires --unique_id below 2^63");
+    // Background rounds are not retried, a failure surfaces on the learning thread.
+    auto connection = make_sockets(unique_id_arg | ASYNC_ID_BIT, total_arg, node_arg);
+    all->async_averager = VW::make_unique<VW::async_averager>(
+        *all, std::move(connection), async_averaging_arg, async_averaging_seconds_arg, async_averaging_alpha_arg);
   }
 
   parse_diagnostics(*all->options, *all);
@@ -1988,6 +2145,21 @@ void finish(VW::workspace& all, bool delete_all)
   if (!all.quiet && !all.options->was_supplied("audit_regressor"))
   { all.sd->print_summary(*all.trace_message, *all.sd, *all.loss, all.current_pass, all.holdout_set_off); }
 
+#ifdef VW_LEARNER_PROFILING
+  if (!all.quiet && all.l != nullptr)
+  {
+    *all.trace_message << std::endl;
+    VW::LEARNER::print_profile_header(*all.trace_message);
+    all.l->print_profile(*all.trace_message);
+  }
+#endif
+
+  if (!all.quiet && all.perf_counters != nullptr)
+  {
+    *all.trace_message << std::endl;
+    all.perf_counters->print(*all.trace_message);
+  }
+
   finalize_regressor(all, all.final_regressor_name);
   if (all.options->was_supplied("dump_json_weights_experimental"))
   {
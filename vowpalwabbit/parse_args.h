@@ -25,6 +25,10 @@ struct input_options
   bool compressed;
   bool chain_hash_json;
   bool flatbuffer = false;
+  // Read only the part of the data file of this node (--shard_by). shard is --node, num_shards --total.
+  std::string shard_by;
+  size_t shard = 0;
+  size_t num_shards = 1;
 #ifdef BUILD_EXTERNAL_PARSER
   // pointer because it is an incomplete type
   std::unique_ptr<VW::external::parser_options> ext_opts;
@@ -591,7 +591,17 @@ void enable_sources(VW::workspace& all, bool quiet, size_t passes, input_options
       try
       {
         std::unique_ptr<VW::io::reader> adapter;
-        if (!filename_to_read.empty())
+        // Multiline text examples end with an empty line, json examples are one per line.
+        const bool blank_line_records =
+            all.l->is_multiline() && !input_options.json && !input_options.dsjson && !input_options.flatbuffer;
+        if (input_options.shard_by == "range")
+        {
+          if (filename_to_read.empty() || should_use_compressed)
+            THROW("--shard_by range needs an uncompressed data file, use --shard_by hash instead");
+          adapter = VW::io::open_file_shard_reader(
+              filename_to_read, input_options.shard, input_options.num_shards, blank_line_records);
+        }
+        else if (!filename_to_read.empty())
         {
           adapter = should_use_compressed ? VW::io::open_compressed_file_reader(filename_to_read)
                                           : VW::io::open_file_reader(filename_to_read);
@@ -612,6 +622,12 @@ void enable_sources(VW::workspace& all, bool quiet, size_t passes, input_options
           input_name = "none";
         }
 
+        if (adapter && input_options.shard_by == "hash")
+        {
+          adapter = VW::io::create_record_hash_filter(
+              std::move(adapter), input_options.shard, input_options.num_shards, blank_line_records);
+        }
+
         if (!quiet) { *(all.trace_message) << "Reading datafile = " << input_name << endl; }
 
         if (adapter) { all.example_parser->input.add_file(std::move(adapter)); }
@@ -687,6 +703,55 @@ void feature_limit(VW::workspace& all, VW::example* ex)
   }
 }
 
+namespace
+{
+// The part of setup_example that only depends on the features: dropped namespaces, skip grams, the constant
+// feature, feature limits, the stride of the weights and the interactions.
+void setup_example_features(VW::workspace& all, VW::example* ae)
+{
+  if (all.ignore_some)
+  {
+    for (unsigned char* i = ae->indices.begin(); i != ae->indices.end(); i++)
+    {
+      if (all.ignore[*i])
+      {
+        // Delete namespace
+        ae->feature_space[*i].clear();
+        i = ae->indices.erase(i);
+        // Offset the increment for this iteration so that is processes this index again which is actually the next
+        // item.
+        i--;
+      }
+    }
+  }
+
+  if (all.skip_gram_transformer != nullptr) { all.skip_gram_transformer->generate_grams(ae); }
+
+  if (all.add_constant)
+  {  // add constant feature
+    VW::add_constant_feature(all, ae);
+  }
+
+  if (!all.limit_strings.empty()) { feature_limit(all, ae); }
+
+  uint64_t multiplier = static_cast<uint64_t>(all.wpp) << all.weights.stride_shift();
+
+  if (multiplier != 1)
+  {  // make room for per-feature information.
+    for (features& fs : *ae)
+    {
+      for (auto& j : fs.indices) { j *= multiplier; }
+    }
+  }
+  ae->num_features = 0;
+  for (const features& fs : *ae) { ae->num_features += fs.size(); }
+
+  // Set the interactions for this example to the global set.
+  ae->interactions = &all.interactions;
+  ae->extent_interactions = &all.extent_interactions;
+}
+}  // namespace
+
 namespace VW
 {
 VW::example& get_unused_example(VW::workspace* all)
@@ -746,46 +811,23 @@ void setup_example(VW::workspace& all, VW::example* ae)
 
   ae->weight = all.example_parser->lbl_parser.get_weight(ae->l, ae->_reduction_features);
 
-  if (all.ignore_some)
-  {
-    for (unsigned char* i = ae->indices.begin(); i != ae->indices.end(); i++)
-    {
-      if (all.ignore[*i])
-      {
-        // Delete namespace
-        ae->feature_space[*i].clear();
-        i = ae->indices.erase(i);
-        // Offset the increment for this iteration so that is processes this index again which is actually the next
-        // item.
-        i--;
-      }
-    }
-  }
-
-  if (all.skip_gram_transformer != nullptr) { all.skip_gram_transformer->generate_grams(ae); }
-
-  if (all.add_constant)
-  {  // add constant feature
-    VW::add_constant_feature(all, ae);
-  }
-
-  if (!all.limit_strings.empty()) { feature_limit(all, ae); }
+  setup_example_features(all, ae);
+}
 
-  uint64_t multiplier = static_cast<uint64_t>(all.wpp) << all.weights.stride_shift();
+void setup_example_for_predict(VW::workspace& all, VW::example* ae)
+{
+  if (all.example_parser->sort_features && ae->sorted == false) { unique_sort_features(all.parse_mask, ae); }
 
-  if (multiplier != 1)
-  {  // make room for per-feature information.
-    for (features& fs : *ae)
-    {
-      for (auto& j : fs.indices) { j *= multiplier; }
-    }
-  }
+  ae->partial_prediction = 0.;
   ae->num_features = 0;
-  for (const features& fs : *ae) { ae->num_features += fs.size(); }
+  ae->reset_total_sum_feat_sq();
+  ae->loss = 0.;
+  ae->_debug_current_reduction_depth = 0;
+  ae->use_permutations = all.permutations;
+  ae->test_only = true;
+  ae->weight = all.example_parser->lbl_parser.get_weight(ae->l, ae->_reduction_features);
 
-  // Set the interactions for this example to the global set.
-  ae->interactions = &all.interactions;
-  ae->extent_interactions = &all.extent_interactions;
+  setup_example_features(all, ae);
 }
 }  // namespace VW
 
@@ -932,7 +974,11 @@ void thread_dispatch(VW::workspace& all, const VW::v_array<VW::example*>& exampl
   for (auto example : examples) { all.example_parser->ready_parsed_examples.push(example); }
 }
 
-void main_parse_loop(VW::workspace* all) { parse_dispatch(*all, thread_dispatch); }
+void main_parse_loop(VW::workspace* all)
+{
+  VW::perf_phase_scope perf_scope(all->perf_counters.get(), VW::perf_phase::parse);
+  parse_dispatch(*all, thread_dispatch);
+}
 
 namespace VW
 {
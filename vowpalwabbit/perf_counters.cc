@@ -0,0 +1,328 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "perf_counters.h"
+
+#include "fmt/format.h"
+#include "vw_exception.h"
+
+#include <string>
+
+#ifdef __linux__
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+
+#  include <cerrno>
+#  include <cstring>
+#endif
+
+namespace VW
+{
+const char* to_string(perf_phase phase)
+{
+  switch (phase)
+  {
+    case perf_phase::parse:
+      return "parse";
+    case perf_phase::learn:
+      return "learn";
+    case perf_phase::output:
+      return "output";
+    default:
+      return "unknown";
+  }
+}
+
+const char* to_string(perf_event event)
+{
+  switch (event)
+  {
+    case perf_event::cycles:
+      return "cycles";
+    case perf_event::instructions:
+      return "instructions";
+    case perf_event::llc_misses:
+      return "llc_misses";
+    case perf_event::dtlb_misses:
+      return "dtlb_misses";
+    default:
+      return "unknown";
+  }
+}
+
+namespace
+{
+constexpr size_t NUM_EVENTS = static_cast<size_t>(perf_event::count);
+constexpr size_t NUM_PHASES = static_cast<size_t>(perf_phase::count);
+
+#ifdef __linux__
+// The counters of one thread, opened as a single group led by the cycle counter so that all of them are
+// scheduled together and can be read with one read() call.
+struct thread_event_group
+{
+  bool opened = false;
+  int leader = -1;
+  std::array<int, NUM_EVENTS> fds;
+  // Position of each event in the group read, only valid if its fd is open.
+  std::array<size_t, NUM_EVENTS> positions{};
+  size_t num_open = 0;
+  int open_errno = 0;
+
+  thread_event_group() { fds.fill(-1); }
+
+  // The leader is fds[cycles], so this closes every counter of the group.
+  ~thread_event_group()
+  {
+    for (int fd : fds)
+    {
+      if (fd != -1) { close(fd); }
+    }
+  }
+
+  thread_event_group(const thread_event_group&) = delete;
+  thread_event_group& operator=(const thread_event_group&) = delete;
+
+  static int open_event(uint32_t type, uint64_t config, int group_fd)
+  {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group_fd == -1 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // The times let read() scale the counts when the kernel multiplexes more groups than the pmu has counters.
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // pid 0, cpu -1: the calling thread on whichever cpu it runs.
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+  }
+
+  static constexpr uint64_t cache_miss(uint64_t cache)
+  {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  }
+
+  void open()
+  {
+    opened = true;
+    leader = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (leader == -1)
+    {
+      open_errno = errno;
+      return;
+    }
+    fds[static_cast<size_t>(perf_event::cycles)] = leader;
+    positions[static_cast<size_t>(perf_event::cycles)] = num_open++;
+
+    const auto add_member = [this](perf_event event, uint32_t type, uint64_t config) {
+      // Not every cpu (or virtual machine) exposes every event, those are reported as unsupported.
+      const int fd = open_event(type, config, leader);
+      if (fd == -1) { return; }
+      fds[static_cast<size_t>(event)] = fd;
+      positions[static_cast<size_t>(event)] = num_open++;
+    };
+    add_member(perf_event::instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    add_member(perf_event::llc_misses, PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_LL));
+    add_member(perf_event::dtlb_misses, PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_DTLB));
+
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+
+  bool read(perf_counter_values& values) const
+  {
+    if (leader == -1) { return false; }
+    // Layout: the number of counters, the time the group was enabled and running, then the counter values.
+    constexpr size_t HEADER = 3;
+    std::array<uint64_t, HEADER + NUM_EVENTS> buffer{};
+    const auto bytes = ::read(leader, buffer.data(), sizeof(buffer));
+    if (bytes < static_cast<ssize_t>(sizeof(uint64_t) * (HEADER + num_open))) { return false; }
+    const uint64_t enabled = buffer[1];
+    const uint64_t running = buffer[2];
+    // Never scheduled yet, there is nothing to extrapolate from.
+    if (running == 0) { return false; }
+    // While multiplexed the group only counted for running of the enabled time, extrapolate to the whole time.
+    const double scale = static_cast<double>(enabled) / static_cast<double>(running);
+    for (size_t i = 0; i < NUM_EVENTS; i++)
+    {
+      if (fds[i] == -1) { continue; }
+      const uint64_t raw = buffer[HEADER + positions[i]];
+      values.values[i] = running < enabled ? static_cast<uint64_t>(static_cast<double>(raw) * scale) : raw;
+    }
+    return true;
+  }
+};
+
+thread_event_group& this_thread_group()
+{
+  static thread_local thread_event_group group;
+  if (!group.opened) { group.open(); }
+  return group;
+}
+#endif
+
+// The innermost active scope on this thread.
+perf_phase_scope*& current_scope()
+{
+  static thread_local perf_phase_scope* scope = nullptr;
+  return scope;
+}
+}  // namespace
+
+perf_counters::perf_counters(VW::io::logger logger, uint64_t sample_interval)
+    : _logger(std::move(logger)), _sample_interval(sample_interval == 0 ? 1 : sample_interval)
+{
+  for (auto& supported : _supported) { supported = false; }
+  for (auto& phase : _totals)
+  {
+    for (auto& total : phase) { total = 0; }
+  }
+#ifndef __linux__
+  _logger.err_warn("--perf_counters is only supported on Linux, no hardware counters will be reported.");
+  _warned = true;
+#endif
+}
+
+bool perf_counters::read_thread(perf_counter_values& values)
+{
+#ifdef __linux__
+  const auto& group = this_thread_group();
+  if (group.leader == -1)
+  {
+    if (!_warned.exchange(true))
+    {
+      _logger.err_warn(
+          "--perf_counters: perf_event_open failed ({}), no hardware counters will be reported. Check "
+          "/proc/sys/kernel/perf_event_paranoid.",
+          std::strerror(group.open_errno));
+    }
+    return false;
+  }
+  for (size_t i = 0; i < NUM_EVENTS; i++)
+  {
+    if (group.fds[i] != -1 && !_supported[i].load(std::memory_order_relaxed)) { _supported[i] = true; }
+  }
+  return group.read(values);
+#else
+  _UNUSED(values);
+  return false;
+#endif
+}
+
+void perf_counters::add(perf_phase phase, const perf_counter_values& counts)
+{
+  auto& totals = _totals[static_cast<size_t>(phase)];
+  for (size_t i = 0; i < NUM_EVENTS; i++)
+  {
+    if (counts.values[i] > 0) { totals[i].fetch_add(counts.values[i], std::memory_order_relaxed); }
+  }
+}
+
+uint64_t perf_counters::get(perf_phase phase, perf_event event) const
+{
+  return _totals[static_cast<size_t>(phase)][static_cast<size_t>(event)].load();
+}
+
+void perf_counters::print(std::ostream& out) const
+{
+  const auto format_value = [this](perf_phase phase, perf_event event) {
+    return is_supported(event) ? std::to_string(get(phase, event)) : std::string("n/a");
+  };
+
+  if (_sample_interval > 1)
+  {
+    out << fmt::format("learn and output are extrapolated from one in {} examples\n", _sample_interval);
+  }
+  out << fmt::format("{:<12}{:>18}{:>18}{:>8}{:>16}{:>16}\n", "phase", "cycles", "instructions", "IPC",
+      "LLC misses", "dTLB misses");
+  for (size_t i = 0; i < NUM_PHASES; i++)
+  {
+    const auto phase = static_cast<perf_phase>(i);
+    const auto cycles = get(phase, perf_event::cycles);
+    const auto instructions = get(phase, perf_event::instructions);
+    const auto ipc = is_supported(perf_event::instructions) && cycles > 0
+        ? fmt::format("{:.2f}", static_cast<double>(instructions) / cycles)
+        : std::string("n/a");
+    out << fmt::format("{:<12}{:>18}{:>18}{:>8}{:>16}{:>16}\n", to_string(phase),
+        format_value(phase, perf_event::cycles), format_value(phase, perf_event::instructions), ipc,
+        format_value(phase, perf_event::llc_misses), format_value(phase, perf_event::dtlb_misses));
+  }
+}
+
+void perf_counters::persist(metric_sink& metrics) const
+{
+  for (size_t i = 0; i < NUM_PHASES; i++)
+  {
+    const auto phase = static_cast<perf_phase>(i);
+    for (size_t j = 0; j < NUM_EVENTS; j++)
+    {
+      const auto event = static_cast<perf_event>(j);
+      if (!is_supported(event)) { continue; }
+      metrics.set_uint(fmt::format("perf_{}_{}", to_string(phase), to_string(event)), get(phase, event));
+    }
+  }
+}
+
+perf_phase_scope::perf_phase_scope(perf_counters* counters, perf_phase phase, bool sampled)
+    : _counters(counters), _phase(phase)
+{
+  if (_counters == nullptr) { return; }
+  if (sampled)
+  {
+    // Unsampled scopes do not read the counters at all, their counts stay with the enclosing scope until it
+    // subtracts the extrapolated counts of the sampled ones.
+    static thread_local uint64_t num_scopes = 0;
+    if (num_scopes++ % _counters->sample_interval() != 0) { return; }
+    _weight = _counters->sample_interval();
+  }
+  perf_counter_values now;
+  if (!_counters->read_thread(now)) { return; }
+  _active = true;
+  _parent = current_scope();
+  current_scope() = this;
+  _start = now;
+  _last = now;
+}
+
+perf_phase_scope::~perf_phase_scope()
+{
+  if (!_active) { return; }
+  perf_counter_values now = _last;
+  if (_counters->read_thread(now)) { charge(now); }
+  current_scope() = _parent;
+  if (_parent == nullptr) { return; }
+  // Everything between _start and now is part of the parent's time as well, so it must not be charged twice.
+  for (size_t i = 0; i < NUM_EVENTS; i++)
+  {
+    if (now.values[i] > _start.values[i])
+    { _parent->_children.values[i] += (now.values[i] - _start.values[i]) * _weight; }
+  }
+}
+
+void perf_phase_scope::switch_to(perf_phase phase)
+{
+  if (!_active) { return; }
+  perf_counter_values now = _last;
+  if (_counters->read_thread(now)) { charge(now); }
+  _phase = phase;
+}
+
+void perf_phase_scope::charge(const perf_counter_values& now)
+{
+  perf_counter_values counts;
+  for (size_t i = 0; i < NUM_EVENTS; i++)
+  {
+    const uint64_t elapsed = now.values[i] > _last.values[i] ? now.values[i] - _last.values[i] : 0;
+    // The extrapolated counts of inner scopes may exceed what was actually counted.
+    const uint64_t own = elapsed > _children.values[i] ? elapsed - _children.values[i] : 0;
+    counts.values[i] = own * _weight;
+  }
+  _counters->add(_phase, counts);
+  _last = now;
+  _children = perf_counter_values{};
+}
+}  // namespace VW
@@ -0,0 +1,111 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+#pragma once
+
+// Hardware performance counters (--perf_counters). Counts cycles, instructions, last level cache misses and
+// data TLB misses of the calling thread using Linux perf_event_open, and attributes them to the phases of the
+// driver. On other platforms or when the kernel refuses access, counting is disabled with a warning.
+
+#include "io/logger.h"
+#include "metric_sink.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+namespace VW
+{
+enum class perf_phase : size_t
+{
+  parse = 0,
+  learn,
+  output,
+  count  // must be last
+};
+
+const char* to_string(perf_phase phase);
+
+enum class perf_event : size_t
+{
+  cycles = 0,
+  instructions,
+  llc_misses,
+  dtlb_misses,
+  count  // must be last
+};
+
+const char* to_string(perf_event event);
+
+struct perf_counter_values
+{
+  std::array<uint64_t, static_cast<size_t>(perf_event::count)> values{};
+
+  uint64_t& operator[](perf_event event) { return values[static_cast<size_t>(event)]; }
+  uint64_t operator[](perf_event event) const { return values[static_cast<size_t>(event)]; }
+};
+
+class perf_counters
+{
+public:
+  // Sampled scopes only measure one in sample_interval of them and extrapolate.
+  explicit perf_counters(VW::io::logger logger, uint64_t sample_interval = 1);
+
+  // Reads the counters of the calling thread. The counters of a thread are opened on its first read.
+  // Returns false if counting is not possible, in which case values is left untouched.
+  bool read_thread(perf_counter_values& values);
+
+  // Adds counts to phase. May be called concurrently from different threads.
+  void add(perf_phase phase, const perf_counter_values& counts);
+
+  uint64_t get(perf_phase phase, perf_event event) const;
+  bool is_supported(perf_event event) const { return _supported[static_cast<size_t>(event)].load(); }
+  uint64_t sample_interval() const { return _sample_interval; }
+
+  void print(std::ostream& out) const;
+  // Keys are of the form perf_<phase>_<event>.
+  void persist(metric_sink& metrics) const;
+
+private:
+  VW::io::logger _logger;
+  uint64_t _sample_interval;
+  std::atomic<bool> _warned{false};
+  std::array<std::atomic<bool>, static_cast<size_t>(perf_event::count)> _supported;
+  std::array<std::array<std::atomic<uint64_t>, static_cast<size_t>(perf_event::count)>,
+      static_cast<size_t>(perf_phase::count)>
+      _totals;
+};
+
+// Attributes the counters of the calling thread to a phase for the lifetime of the scope. Scopes nest: while an
+// inner scope is active its counts are only charged to the inner phase, so wrapping the parser in a parse scope
+// and each example in learn/output scopes gives exclusive numbers even when everything runs on one thread.
+// Every read is a system call, so per example scopes are sampled: only one in sample_interval() of them reads the
+// counters, its counts are multiplied by the interval and taken out of the enclosing scope when it ends.
+// Does nothing when counters is nullptr.
+class perf_phase_scope
+{
+public:
+  perf_phase_scope(perf_counters* counters, perf_phase phase, bool sampled = false);
+  ~perf_phase_scope();
+
+  // Charge everything up to now to the current phase and continue counting for phase.
+  void switch_to(perf_phase phase);
+
+  perf_phase_scope(const perf_phase_scope&) = delete;
+  perf_phase_scope& operator=(const perf_phase_scope&) = delete;
+
+private:
+  void charge(const perf_counter_values& now);
+
+  perf_counters* _counters;
+  perf_phase _phase;
+  perf_phase_scope* _parent = nullptr;
+  perf_counter_values _start;
+  perf_counter_values _last;
+  // Extrapolated counts of inner scopes that ended since _last.
+  perf_counter_values _children;
+  uint64_t _weight = 1;
+  bool _active = false;
+};
+}  // namespace VW
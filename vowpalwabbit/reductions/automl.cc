@@ -4,14 +4,18 @@
 
 #include "automl.h"
 
+#include "config/cli_options_serializer.h"
 #include "config/options.h"
 #include "constant.h"  // NUM_NAMESPACES
 #include "debug_log.h"
 #include "model_utils.h"
 #include "rand_state.h"
 #include "setup_base.h"
+#include "shared_data.h"
 #include "vw.h"
 
+#include <fmt/format.h>
+
 #include <cfloat>
 
 using namespace VW::config;
@@ -169,50 +173,79 @@ interaction_config_manager::interaction_config_manager(uint64_t global_lease, ui
   ++valid_config_size;
 }
 
+namespace
+{
+bool is_excluded(
+    const std::map<namespace_index, std::set<namespace_index>>& exclusions, namespace_index ns1, namespace_index ns2)
+{
+  const auto it = exclusions.find(ns1);
+  return it != exclusions.end() && it->second.find(ns2) != it->second.end();
+}
+}  // namespace
+
 // This code is primarily borrowed from expand_quadratics_wildcard_interactions in
 // interactions.cc. It will generate interactions with -q :: and exclude namespaces
 // from the corresponding live_slot. This function can be swapped out depending on
 // preference of how to generate interactions from a given set of exclusions.
-// Transforms exclusions -> interactions expected by VW.
+// Transforms exclusions -> interactions expected by VW. The interactions are sorted,
+// and the vectors already held by the live_slot are overwritten instead of reallocated.
 void interaction_config_manager::gen_quadratic_interactions(uint64_t live_slot)
 {
   auto& exclusions = configs[scores[live_slot].config_index].exclusions;
   auto& interactions = scores[live_slot].live_interactions;
-  if (!interactions.empty()) { interactions.clear(); }
+  size_t count = 0;
   for (auto it = ns_counter.begin(); it != ns_counter.end(); ++it)
   {
     auto idx1 = (*it).first;
     for (auto jt = it; jt != ns_counter.end(); ++jt)
     {
       auto idx2 = (*jt).first;
-      if (exclusions.find(idx1) == exclusions.end() || exclusions.at(idx1).find(idx2) == exclusions.at(idx1).end())
-      { interactions.push_back({idx1, idx2}); }
+      if (is_excluded(exclusions, idx1, idx2)) { continue; }
+      if (count < interactions.size()) { interactions[count].assign({idx1, idx2}); }
+      else
+      {
+        interactions.push_back({idx1, idx2});
+      }
+      ++count;
     }
   }
+  interactions.resize(count);
+}
+
+// Inserts the interactions of a namespace that was just added to ns_counter into the interactions of
+// live_slot, at the position gen_quadratic_interactions would have generated them.
+void interaction_config_manager::add_namespace_interactions(uint64_t live_slot, namespace_index new_ns)
+{
+  auto& exclusions = configs[scores[live_slot].config_index].exclusions;
+  auto& interactions = scores[live_slot].live_interactions;
+  for (const auto& ns_count : ns_counter)
+  {
+    const std::vector<namespace_index> interaction =
+        ns_count.first < new_ns ? std::vector<namespace_index>{ns_count.first, new_ns}
+                                : std::vector<namespace_index>{new_ns, ns_count.first};
+    if (is_excluded(exclusions, interaction[0], interaction[1])) { continue; }
+    interactions.insert(std::lower_bound(interactions.begin(), interactions.end(), interaction), interaction);
+  }
 }
 
 // This function will process an incoming multi_ex, update the namespace_counter,
-// log if new namespaces are encountered, and regenerate interactions based on
-// newly seen namespaces.
+// log if new namespaces are encountered, and add the interactions of newly seen
+// namespaces to the live configs.
 void interaction_config_manager::pre_process(const multi_ex& ecs)
 {
   // Count all namepsace seen in current example
-  bool new_ns_seen = false;
   for (const example* ex : ecs)
   {
     for (const auto& ns : ex->indices)
     {
       if (std::find(NS_EXCLUDE_LIST.begin(), NS_EXCLUDE_LIST.end(), ns) != NS_EXCLUDE_LIST.end()) { continue; }
-      ns_counter[ns]++;
-      if (ns_counter[ns] == 1) { new_ns_seen = true; }
+      if (++ns_counter[ns] == 1)
+      {
+        for (uint64_t live_slot = 0; live_slot < scores.size(); ++live_slot)
+        { add_namespace_interactions(live_slot, ns); }
+      }
     }
   }
-
-  // Regenerate interactions if new namespaces are seen
-  if (new_ns_seen)
-  {
-    for (uint64_t live_slot = 0; live_slot < scores.size(); ++live_slot) { gen_quadratic_interactions(live_slot); }
-  }
 }
 
 // Helper function to insert new configs from oracle into map of configs as well as index_queue.
@@ -530,6 +563,164 @@ void interaction_config_manager::apply_config(example* ec, uint64_t live_slot)
 
 void interaction_config_manager::revert_config(example* ec) { ec->interactions = nullptr; }
 
+namespace
+{
+// A worker only learns on the examples it is given, so it gets the options that shape features and updates and
+// nothing that reads or writes files, opens sockets or starts threads.
+const std::set<std::string> CORE_OPTIONS_PASSED_TO_WORKERS = {"hash", "hash_seed", "ignore", "ignore_linear", "keep",
+    "redefine", "noconstant", "constant", "ngram", "skips", "feature_limit", "affix", "spelling", "dictionary",
+    "dictionary_path", "experimental_full_name_interactions", "permutations", "leave_duplicate_interactions",
+    "min_prediction", "max_prediction", "sort_features", "loss_function", "quantile_tau", "l1", "l2",
+    "no_bias_regularization", "named_labels", "learning_rate", "power_t", "decay_learning_rate", "initial_t",
+    "sparse_weights", "random_seed"};
+
+// Reduction options set up the learner stack, except for these.
+const std::set<std::string> REDUCTION_OPTIONS_KEPT_FROM_WORKERS = {
+    "automl_threads", "audit_regressor", "extra_metrics", "print"};
+
+std::string encode_interaction(const std::vector<VW::namespace_index>& interaction)
+{
+  // Namespaces may be any byte, write them as escaped hex so the command line keeps them intact.
+  std::string encoded;
+  for (const auto ns : interaction) { encoded += fmt::format("\\\\x{:02x}", ns); }
+  return encoded;
+}
+
+std::string worker_args(VW::workspace& all)
+{
+  std::set<std::string> reduction_options;
+  for (auto const& group : all.options->get_all_option_group_definitions())
+  {
+    if (group.m_name.find("[Reduction]") != 0) { continue; }
+    for (auto const& option : group.m_options) { reduction_options.insert(option->m_name); }
+  }
+
+  cli_options_serializer serializer;
+  for (auto const& option : all.options->get_all_options())
+  {
+    if (!all.options->was_supplied(option->m_name)) { continue; }
+    if (reduction_options.count(option->m_name) != 0 ? REDUCTION_OPTIONS_KEPT_FROM_WORKERS.count(option->m_name) == 0
+                                                      : CORE_OPTIONS_PASSED_TO_WORKERS.count(option->m_name) != 0)
+    { serializer.add(*option); }
+  }
+
+  // The bits and interactions in effect may come from a loaded model rather than the command line.
+  std::string args = serializer.str() + " --bit_precision " + std::to_string(all.num_bits);
+  for (const auto& interaction : all.interactions) { args += " --interactions " + encode_interaction(interaction); }
+  return args + " --quiet --no_stdin";
+}
+}  // namespace
+
+live_config_workers::live_config_workers(VW::workspace& all, size_t num_workers)
+    : _all(all), _num_workers(num_workers)
+{
+}
+
+live_config_workers::~live_config_workers()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _work_cv.notify_all();
+  for (auto& thread : _threads) { thread.join(); }
+  for (auto& w : _workers) { VW::finish(*w.all); }
+}
+
+// The workspaces are created on the first example, once the weights of the main workspace exist.
+void live_config_workers::init()
+{
+  const std::string args = worker_args(_all);
+  _workers.resize(_num_workers);
+  for (auto& w : _workers)
+  {
+    w.all = VW::initialize(args, nullptr, true /* skip_model_load */);
+    w.all->weights.shallow_copy(_all.weights);
+    w.base = as_multiline(w.all->l->get_learner_by_name_prefix("automl")->get_learn_base());
+  }
+  for (size_t i = 0; i < _num_workers; i++) { _threads.emplace_back(&live_config_workers::run, this, i); }
+}
+
+void live_config_workers::start(interaction_config_manager& cm, const multi_ex& ec)
+{
+  if (_workers.empty()) { init(); }
+  _cm = &cm;
+  _chosen_actions.resize(cm.scores.size());
+  for (auto& w : _workers)
+  {
+    // the reductions below read the label range and example counts of the shared data
+    *w.all->sd = *_all.sd;
+    while (w.examples.size() < ec.size()) { w.examples.push_back(VW::make_unique<example>()); }
+    w.ec.clear();
+    for (size_t i = 0; i < ec.size(); i++)
+    {
+      VW::copy_example_data_with_label(w.examples[i].get(), ec[i]);
+      w.ec.push_back(w.examples[i].get());
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _busy = _workers.size();
+    _round++;
+  }
+  _work_cv.notify_all();
+}
+
+void live_config_workers::wait()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _done_cv.wait(lock, [this] { return _busy == 0; });
+}
+
+void live_config_workers::finish()
+{
+  wait();
+  if (_error)
+  {
+    auto error = _error;
+    _error = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void live_config_workers::run(size_t id)
+{
+  worker& w = _workers[id];
+  uint64_t round = 0;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _work_cv.wait(lock, [this, round] { return _stop || _round != round; });
+      if (_stop) { return; }
+      round = _round;
+    }
+
+    try
+    {
+      for (uint64_t live_slot = id + 1; live_slot < _cm->scores.size(); live_slot += _num_workers + 1)
+      {
+        for (example* ex : w.ec) { _cm->apply_config(ex, live_slot); }
+        if (!w.base->learn_returns_prediction) { w.base->predict(w.ec, live_slot); }
+        w.base->learn(w.ec, live_slot);
+        _chosen_actions[live_slot] = w.ec[0]->pred.a_s[0].action;
+        if (_cm->current_champ == live_slot) { _champ_a_s = w.ec[0]->pred.a_s; }
+      }
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_error) { _error = std::current_exception(); }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _busy--;
+    }
+    _done_cv.notify_all();
+  }
+}
+
 template <typename CMType, bool is_explore>
 void predict_automl(automl<CMType>& data, multi_learner& base, multi_ex& ec)
 {
@@ -550,21 +741,44 @@ void automl<CMType>::offset_learn(multi_learner& base, multi_ex& ec, CB::cb_clas
   const float w = logged.probability > 0 ? 1 / logged.probability : 0;
   const float r = -logged.cost;
 
-  for (uint64_t live_slot = 0; live_slot < cm->scores.size(); ++live_slot)
+  // the workers copy the examples before the main thread starts to learn on them
+  if (workers) { workers->start(*cm, ec); }
+  try
   {
-    for (example* ex : ec) { cm->apply_config(ex, live_slot); }
+    for (uint64_t live_slot = 0; live_slot < cm->scores.size(); ++live_slot)
+    {
+      if (workers && !workers->is_main_slot(live_slot)) { continue; }
+      for (example* ex : ec) { cm->apply_config(ex, live_slot); }
 
-    auto restore_guard = VW::scope_exit([this, &ec] {
-      for (example* ex : ec) { this->cm->revert_config(ex); }
-    });
+      auto restore_guard = VW::scope_exit([this, &ec] {
+        for (example* ex : ec) { this->cm->revert_config(ex); }
+      });
 
-    if (!base.learn_returns_prediction) { base.predict(ec, live_slot); }
-    base.learn(ec, live_slot);
-    const uint32_t chosen_action = ec[0]->pred.a_s[0].action;
-    cm->scores[live_slot].update(chosen_action == labelled_action ? w : 0, r);
+      if (!base.learn_returns_prediction) { base.predict(ec, live_slot); }
+      base.learn(ec, live_slot);
+      const uint32_t chosen_action = ec[0]->pred.a_s[0].action;
+      cm->scores[live_slot].update(chosen_action == labelled_action ? w : 0, r);
 
-    // cache the champ
-    if (cm->current_champ == live_slot) { champ_a_s = std::move(ec[0]->pred.a_s); }
+      // cache the champ
+      if (cm->current_champ == live_slot) { champ_a_s = std::move(ec[0]->pred.a_s); }
+    }
+  }
+  catch (...)
+  {
+    if (workers) { workers->wait(); }
+    throw;
+  }
+
+  if (workers)
+  {
+    workers->finish();
+    for (uint64_t live_slot = 0; live_slot < cm->scores.size(); ++live_slot)
+    {
+      if (workers->is_main_slot(live_slot)) { continue; }
+      const uint32_t chosen_action = workers->chosen_action(live_slot);
+      cm->scores[live_slot].update(chosen_action == labelled_action ? w : 0, r);
+      if (cm->current_champ == live_slot) { champ_a_s = workers->champ_a_s(); }
+    }
   }
   // replace bc champ always gets cached
   ec[0]->pred.a_s = std::move(champ_a_s);
@@ -658,6 +872,7 @@ VW::LEARNER::base_learner* automl_setup(VW::setup_base_i& stack_builder)
   std::string oracle_type;
   float automl_alpha;
   float automl_tau;
+  uint64_t automl_threads;
 
   option_group_definition new_options("[Reduction] Automl");
   new_options
@@ -698,7 +913,11 @@ VW::LEARNER::base_learner* automl_setup(VW::setup_base_i& stack_builder)
       .add(make_option("automl_tau", automl_tau)
                .keep()
                .default_value(DEFAULT_TAU)
-               .help("Time constant for count decay"));
+               .help("Time constant for count decay"))
+      .add(make_option("automl_threads", automl_threads)
+               .default_value(1)
+               .help("Learn the live configs on this many threads. Every extra thread runs its own copy of the "
+                     "reductions below automl"));
 
   if (!options.add_parse_and_check_necessary(new_options)) { return nullptr; }
 
@@ -741,6 +960,14 @@ VW::LEARNER::base_learner* automl_setup(VW::setup_base_i& stack_builder)
   assert(all.weights.sparse == false);
   if (all.weights.sparse) THROW("--automl does not work with sparse weights");
 
+  if (automl_threads == 0) { THROW("--automl_threads must be at least 1"); }
+  if (automl_threads > 1)
+  {
+    // the truncation of l1 and l2 is tracked in the shared data, which every thread would update on its own
+    if (all.l1_lambda > 0 || all.l2_lambda > 0) { THROW("--automl_threads does not support --l1 or --l2"); }
+    data->workers = VW::make_unique<live_config_workers>(all, automl_threads - 1);
+  }
+
   details::fail_if_enabled(all,
       {"ccb_explore_adf", "audit_regressor", "baseline", "cb_explore_adf_rnd", "cb_to_cb_adf", "cbify", "replay_c",
           "replay_b", "replay_m", "memory_tree", "new_mf", "nn", "stage_poly"});
@@ -15,10 +15,15 @@
 
 #include <fmt/format.h>
 
+#include <condition_variable>
+#include <exception>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <set>
+#include <thread>
+#include <vector>
 
 using namespace VW::config;
 using namespace VW::LEARNER;
@@ -144,6 +149,7 @@ struct interaction_config_manager : config_manager
 
   // Public for save_load
   void gen_quadratic_interactions(uint64_t);
+  void add_namespace_interactions(uint64_t, namespace_index);
 
 private:
   bool better(const exclusion_config&, const exclusion_config&) const;
@@ -154,12 +160,66 @@ private:
   void insert_config(std::map<namespace_index, std::set<namespace_index>>&&);
 };
 
+// Learns some of the live configs on other threads while the main thread learns the rest. Every worker has a
+// workspace of its own that shares the weights of the main one, so it runs its own copy of the reductions below
+// automl on its own copy of the examples. The live configs use disjoint weight offsets, hence the threads never
+// update the same weights.
+class live_config_workers
+{
+public:
+  live_config_workers(VW::workspace& all, size_t num_workers);
+  ~live_config_workers();
+
+  // the main thread learns the live slots for which this is true, worker i those with live_slot % (n + 1) == i + 1
+  bool is_main_slot(uint64_t live_slot) const { return live_slot % (_num_workers + 1) == 0; }
+  // copies ec for every worker and starts learning their live slots of cm
+  void start(interaction_config_manager& cm, const multi_ex& ec);
+  // waits for the workers to finish the live slots that were started
+  void wait();
+  // waits and rethrows the error of a worker
+  void finish();
+  // the action chosen by a live slot of the workers in the last round
+  uint32_t chosen_action(uint64_t live_slot) const { return _chosen_actions[live_slot]; }
+  // the prediction of the champ if a worker learned it in the last round
+  ACTION_SCORE::action_scores& champ_a_s() { return _champ_a_s; }
+
+private:
+  struct worker
+  {
+    VW::workspace* all = nullptr;
+    multi_learner* base = nullptr;
+    std::vector<std::unique_ptr<example>> examples;
+    multi_ex ec;
+  };
+
+  void init();
+  void run(size_t id);
+
+  VW::workspace& _all;
+  size_t _num_workers;
+  std::vector<worker> _workers;
+  std::vector<std::thread> _threads;
+
+  std::mutex _mutex;
+  std::condition_variable _work_cv;
+  std::condition_variable _done_cv;
+  uint64_t _round = 0;
+  size_t _busy = 0;
+  bool _stop = false;
+  std::exception_ptr _error;
+
+  interaction_config_manager* _cm = nullptr;
+  std::vector<uint32_t> _chosen_actions;
+  ACTION_SCORE::action_scores _champ_a_s;
+};
+
 template <typename CMType>
 struct automl
 {
   automl_state current_state = automl_state::Collecting;
   std::unique_ptr<CMType> cm;
   LEARNER::multi_learner* adf_learner = nullptr;  //  re-use print from cb_explore_adf
+  std::unique_ptr<live_config_workers> workers;   // only set with --automl_threads > 1
   automl(std::unique_ptr<CMType> cm) : cm(std::move(cm)) {}
   // This fn gets called before learning any example
   void one_step(multi_learner&, multi_ex&, CB::cb_class&, uint64_t);
@@ -161,31 +161,32 @@ uint32_t cats_tree::predict(LEARNER::single_learner& base, example& ec)
   if (_binary_tree.leaf_node_count() == 0) { return 0; }
   CB::label saved_label = std::move(ec.l.cb);
   ec.l.simple.label = std::numeric_limits<float>::max();  // says it is a test example
-  auto cur_node = nodes[0];
+  // one binary prediction per level of the min depth tree, O(log k) for k leaves
+  const tree_node* cur_node = &nodes[0];
 
-  while (!(cur_node.is_leaf))
+  while (!(cur_node->is_leaf))
   {
-    if (cur_node.right_only) { cur_node = nodes[cur_node.right_id]; }
-    else if (cur_node.left_only)
+    if (cur_node->right_only) { cur_node = &nodes[cur_node->right_id]; }
+    else if (cur_node->left_only)
     {
-      cur_node = nodes[cur_node.left_id];
+      cur_node = &nodes[cur_node->left_id];
     }
     else
     {
       ec.partial_prediction = 0.f;
       ec.pred.scalar = 0.f;
-      base.predict(ec, cur_node.id);
+      base.predict(ec, cur_node->id);
       VW_DBG(ec) << "tree_c: predict() after base.predict() " << VW::debug::scalar_pred_to_string(ec)
-                 << ", nodeid = " << cur_node.id << std::endl;
-      if (ec.pred.scalar < 0) { cur_node = nodes[cur_node.left_id]; }
+                 << ", nodeid = " << cur_node->id << std::endl;
+      if (ec.pred.scalar < 0) { cur_node = &nodes[cur_node->left_id]; }
       else
       {
-        cur_node = nodes[cur_node.right_id];
+        cur_node = &nodes[cur_node->right_id];
       }
     }
   }
   ec.l.cb = std::move(saved_label);
-  return (cur_node.id - _binary_tree.internal_node_count() + 1);  // 1 to k
+  return (cur_node->id - _binary_tree.internal_node_count() + 1);  // 1 to k
 }
 
 void cats_tree::init_node_costs(std::vector<cb_class>& ac)
@@ -244,11 +245,12 @@ void cats_tree::learn(LEARNER::single_learner& base, example& ec)
 
   for (uint32_t d = _binary_tree.depth(); d > 0; d--)
   {
-    std::vector<node_cost> set_d = {_a};
-    if (nodes[_a.node_id].parent_id != nodes[_b.node_id].parent_id) { set_d.push_back(_b); }
+    // at most the two ends of the bandwidth interval are trained per level
+    const node_cost set_d[2] = {_a, _b};
+    const uint32_t set_d_size = nodes[_a.node_id].parent_id != nodes[_b.node_id].parent_id ? 2 : 1;
     float a_parent_cost = _a.cost;
     float b_parent_cost = _b.cost;
-    for (uint32_t i = 0; i < set_d.size(); i++)
+    for (uint32_t i = 0; i < set_d_size; i++)
     {
       const node_cost& n_c = set_d[i];
       const tree_node& v = nodes[n_c.node_id];
@@ -17,6 +17,8 @@
 #include "vw_string_view.h"
 #include "vw_versions.h"
 
+#include <limits>
+
 #undef VW_DEBUG_LOG
 #define VW_DEBUG_LOG vw_dbg::cb_adf
 
@@ -84,6 +86,7 @@ private:
   uint64_t _offset;
   const bool _no_predict;
   const bool _rank_all;
+  const uint32_t _rank_top_k;  // printed actions with rank_all, 0 prints all of them
   const float _clip_p;
 
   VW::io::logger logger;
@@ -91,15 +94,17 @@ private:
 public:
   void learn(VW::LEARNER::multi_learner& base, VW::multi_ex& ec_seq);
   void predict(VW::LEARNER::multi_learner& base, VW::multi_ex& ec_seq);
+  void multipredict(VW::LEARNER::multi_learner& base, VW::multi_ex& ec_seq, size_t count, VW::polyprediction* pred);
   bool update_statistics(const VW::example& ec, const VW::multi_ex& ec_seq);
 
-  cb_adf(shared_data* sd, VW::cb_type_t cb_type, VW::version_struct* model_file_ver, bool rank_all, float clip_p,
-      bool no_predict, VW::io::logger logger)
+  cb_adf(shared_data* sd, VW::cb_type_t cb_type, VW::version_struct* model_file_ver, bool rank_all,
+      uint32_t rank_top_k, float clip_p, bool no_predict, VW::io::logger logger)
       : _sd(sd)
       , _model_file_ver(model_file_ver)
       , _offset(0)
       , _no_predict(no_predict)
       , _rank_all(rank_all)
+      , _rank_top_k(rank_top_k)
       , _clip_p(clip_p)
       , logger(std::move(logger))
   {
@@ -110,6 +115,11 @@ public:
 
   bool get_rank_all() const { return _rank_all; }
 
+  size_t get_rank_top_k() const
+  {
+    return _rank_top_k == 0 ? std::numeric_limits<size_t>::max() : static_cast<size_t>(_rank_top_k);
+  }
+
   const cb_to_cs_adf& get_gen_cs() const { return _gen_cs; }
 
   const VW::version_struct* get_model_file_ver() const { return _model_file_ver; }
@@ -149,8 +159,8 @@ void cb_adf::learn_SM(multi_learner& base, VW::multi_ex& examples)
   // 4: get probability of chosen action;
   // 5: backup example wts;
   // 6: restore example wts]
-  _a_s.clear();
-  _prob_s.clear();
+  _a_s.clear_noshrink();
+  _prob_s.clear_noshrink();
   // TODO: Check that predicted scores are always stored with the first example
   for (uint32_t i = 0; i < examples[0]->pred.a_s.size(); i++)
   {
@@ -164,7 +174,7 @@ void cb_adf::learn_SM(multi_learner& base, VW::multi_ex& examples)
 
   for (uint32_t i = 0; i < examples.size(); i++)
   {
-    CB::label ld = examples[i]->l.cb;
+    const CB::label& ld = examples[i]->l.cb;
     if (ld.costs.size() == 1 && ld.costs[0].cost != FLT_MAX)
     {
       chosen_action = i;
@@ -198,8 +208,8 @@ void cb_adf::learn_SM(multi_learner& base, VW::multi_ex& examples)
     }
   }
 
-  _backup_weights.clear();
-  _backup_nf.clear();
+  _backup_weights.clear_noshrink();
+  _backup_nf.clear_noshrink();
   for (auto const& action_score : _prob_s)
   {
     uint32_t current_action = action_score.action;
@@ -347,6 +357,15 @@ void cb_adf::predict(multi_learner& base, VW::multi_ex& ec_seq)
   cs_ldf_learn_or_predict<false>(base, ec_seq, _cb_labels, _cs_labels, _prepped_cs_labels, false, _offset);
 }
 
+// predict for count offsets, with a single traversal of the features of every action when the base supports it
+void cb_adf::multipredict(multi_learner& base, VW::multi_ex& ec_seq, size_t count, VW::polyprediction* pred)
+{
+  _offset = ec_seq[0]->ft_offset;
+  _gen_cs.known_cost = get_observed_cost_or_default_cb_adf(ec_seq);  // need to set for test case
+  gen_cs_test_example(ec_seq, _cs_labels);                           // create test labels.
+  GEN_CS::cs_ldf_multipredict(base, ec_seq, _cb_labels, _cs_labels, _prepped_cs_labels, _offset, 0, count, pred);
+}
+
 void global_print_newline(
     const std::vector<std::unique_ptr<VW::io::writer>>& final_prediction_sink, VW::io::logger& logger)
 {
@@ -423,7 +442,8 @@ void output_rank_example(VW::workspace& all, cb_adf& c, const VW::example& ec, c
 
   bool labeled_example = c.update_statistics(ec, ec_seq);
 
-  for (auto& sink : all.final_prediction_sink) { print_action_score(sink.get(), ec.pred.a_s, ec.tag, all.logger); }
+  for (auto& sink : all.final_prediction_sink)
+  { print_action_score(sink.get(), ec.pred.a_s, ec.tag, all.logger, c.get_rank_top_k()); }
 
   if (all.raw_prediction != nullptr)
   {
@@ -493,6 +513,12 @@ void learn(cb_adf& c, multi_learner& base, VW::multi_ex& ec_seq) { c.learn(base,
 
 void predict(cb_adf& c, multi_learner& base, VW::multi_ex& ec_seq) { c.predict(base, ec_seq); }
 
+void multipredict(cb_adf& c, multi_learner& base, VW::multi_ex& ec_seq, size_t count, size_t /* step */,
+    VW::polyprediction* pred, bool /* finalize_predictions */)
+{
+  c.multipredict(base, ec_seq, count, pred);
+}
+
 }  // namespace CB_ADF
 using namespace CB_ADF;
 base_learner* cb_adf_setup(VW::setup_base_i& stack_builder)
@@ -504,6 +530,7 @@ base_learner* cb_adf_setup(VW::setup_base_i& stack_builder)
 
   VW::cb_type_t cb_type;
   bool rank_all;
+  uint32_t rank_top_k = 0;
   float clip_p;
   bool no_predict;
 
@@ -514,6 +541,10 @@ base_learner* cb_adf_setup(VW::setup_base_i& stack_builder)
                .necessary()
                .help("Do Contextual Bandit learning with multiline action dependent features"))
       .add(make_option("rank_all", rank_all).keep().help("Return actions sorted by score order"))
+      .add(make_option("rank_top_k", rank_top_k)
+               .default_value(0)
+               .help("With --rank_all, only sort and print the k best actions. The remaining actions are kept in the "
+                     "prediction in no particular order. 0 ranks all actions"))
       .add(make_option("no_predict", no_predict).help("Do not do a prediction when training"))
       .add(make_option("clip_p", clip_p)
                .keep()
@@ -570,14 +601,18 @@ base_learner* cb_adf_setup(VW::setup_base_i& stack_builder)
 
   if (options.was_supplied("baseline") && check_baseline_enabled) { options.insert("check_enabled", ""); }
 
-  auto ld = VW::make_unique<cb_adf>(all.sd, cb_type, &all.model_file_ver, rank_all, clip_p, no_predict, all.logger);
+  auto ld = VW::make_unique<cb_adf>(
+      all.sd, cb_type, &all.model_file_ver, rank_all, rank_top_k, clip_p, no_predict, all.logger);
 
   auto base = as_multiline(stack_builder.setup_base_learner());
   all.example_parser->lbl_parser = CB::cb_label;
 
   cb_adf* bare = ld.get();
   bool lrp = ld->learn_returns_prediction();
+  // the offsets of the base are only contiguous with a single weight vector
+  auto* multipredict_ptr = problem_multiplier == 1 ? CB_ADF::multipredict : nullptr;
   auto* l = make_reduction_learner(std::move(ld), base, learn, predict, stack_builder.get_setupfn_name(cb_adf_setup))
+                .set_multipredict(multipredict_ptr)
                 .set_input_label_type(VW::label_type_t::cb)
                 .set_output_label_type(VW::label_type_t::cs)
                 .set_input_prediction_type(VW::prediction_type_t::action_scores)
@@ -42,6 +42,7 @@ private:
   v_array<ACTION_SCORE::action_score> _action_probs;
   std::vector<float> _scores;
   std::vector<float> _top_actions;
+  std::vector<VW::polyprediction> _bag_preds;
 
 public:
   using PredictionT = v_array<ACTION_SCORE::action_score>;
@@ -94,25 +95,28 @@ void cb_explore_adf_bag::predict(VW::LEARNER::multi_learner& base, multi_ex& exa
   _scores.assign(num_actions, 0.f);
   _top_actions.assign(num_actions, 0);
 
+  // all policies of the bag are predicted in one pass over the features of the actions
+  _bag_preds.resize(_bag_size);
+  VW::LEARNER::multiline_multipredict(base, examples, examples[0]->ft_offset, 0, _bag_size, _bag_preds.data());
+
   for (uint32_t i = 0; i < _bag_size; i++)
   {
-    VW::LEARNER::multiline_learn_or_predict<false>(base, examples, examples[0]->ft_offset, i);
-
-    assert(preds.size() == num_actions);
-    for (auto e : preds) { _scores[e.action] += e.score; }
+    const auto& bag_preds = _bag_preds[i].a_s;
+    assert(bag_preds.size() == num_actions);
+    for (auto e : bag_preds) { _scores[e.action] += e.score; }
 
     if (!_first_only)
     {
-      size_t tied_actions = fill_tied(preds);
-      for (size_t j = 0; j < tied_actions; ++j) { _top_actions[preds[j].action] += 1.f / tied_actions; }
+      size_t tied_actions = fill_tied(bag_preds);
+      for (size_t j = 0; j < tied_actions; ++j) { _top_actions[bag_preds[j].action] += 1.f / tied_actions; }
     }
     else
     {
-      _top_actions[preds[0].action] += 1.f;
+      _top_actions[bag_preds[0].action] += 1.f;
     }
   }
 
-  _action_probs.clear();
+  _action_probs.clear_noshrink();
   for (uint32_t i = 0; i < _scores.size(); i++) { _action_probs.push_back({i, 0.}); }
 
   // generate distribution over actions
@@ -121,6 +125,7 @@ void cb_explore_adf_bag::predict(VW::LEARNER::multi_learner& base, multi_ex& exa
 
   exploration::enforce_minimum_probability(_epsilon, true, begin_scores(_action_probs), end_scores(_action_probs));
   sort_action_probs(_action_probs, _scores);
+  preds.resize_but_with_stl_behavior(_action_probs.size());
   std::copy(std::begin(_action_probs), std::end(_action_probs), std::begin(preds));
 }
 
@@ -0,0 +1,128 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "cb_explore_adf_cost_ranges.h"
+
+#include "example.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+#define B_SEARCH_MAX_ITER 20
+
+using namespace VW::LEARNER;
+
+namespace VW
+{
+namespace cb_explore_adf
+{
+float binary_search(float fhat, float delta, float sens, float tol)
+{
+  // We are always guaranteed that the solution to the problem above lies in (0, maxw), as long as fhat \geq 0.
+  const float maxw = (std::min)(fhat / sens, FLT_MAX);
+
+  // If the objective value for maxw satisfies the delta constraint, we can just take this and skip the binary search.
+  if (maxw * fhat * fhat <= delta) { return maxw; }
+
+  // Upper and lower bounds on w for binary search.
+  float l = 0;
+  float u = maxw;
+  // Binary search variable.
+  float w;
+  // Value for w.
+  float v;
+
+  // Standard binary search given the objective described above.
+  for (int iter = 0; iter < B_SEARCH_MAX_ITER; iter++)
+  {
+    w = (u + l) / 2.f;
+    v = w * (fhat * fhat - (fhat - sens * w) * (fhat - sens * w)) - delta;
+    if (v > 0) { u = w; }
+    else
+    {
+      l = w;
+    }
+    if (std::fabs(v) <= tol || u - l <= tol) { break; }
+  }
+
+  return l;
+}
+
+float closed_form_weight(float fhat, float delta, float sens)
+{
+  const float maxw = (std::min)(fhat / sens, FLT_MAX);
+  const float c = delta * sens / (fhat * fhat * fhat);
+  if (!(c > 0.f)) { return 0.f; }
+  if (c >= 1.f) { return maxw; }
+
+  // The cubic has one root in each of (-1, 0), (0, 1) and (4/3, 2), the middle one is the second trigonometric root.
+  constexpr float two_pi_over_three = 2.0943951f;
+  const float theta = std::acos((std::max)(1.f - 27.f * c / 16.f, -1.f));
+  const float u = 2.f / 3.f + 4.f / 3.f * std::cos(theta / 3.f - two_pi_over_three);
+  return (std::min)(u, 1.f) * maxw;
+}
+
+void cost_ranges::compute(float delta, multi_learner& base, multi_ex& examples, float cmin, float cmax, bool min_only,
+    bool closed_form)
+{
+  const size_t num_actions = examples[0]->pred.a_s.size();
+  min_costs.resize(num_actions);
+  max_costs.resize(num_actions);
+  _preds.resize(num_actions);
+  _min_sens.resize(num_actions);
+  _max_sens.resize(num_actions);
+
+  // Labels and predictions are separate members of the example, so setting the simple label and the scalar prediction
+  // below leaves the cb label and the action scores intact.
+  for (const auto& as : examples[0]->pred.a_s) { examples[as.action]->pred.scalar = as.score; }
+
+  // The sensitivity is the only part that walks the features. Actions whose prediction is outside of the cost range
+  // get the bound directly, so their sensitivity is not needed.
+  constexpr float unused = std::numeric_limits<float>::quiet_NaN();
+  for (size_t a = 0; a < num_actions; ++a)
+  {
+    example* ec = examples[a];
+    const float pred = ec->pred.scalar;
+    _preds[a] = pred;
+
+    ec->l.simple.label = cmin - 1;
+    _min_sens[a] = pred < cmin ? unused : base.sensitivity(*ec);
+    if (!min_only)
+    {
+      ec->l.simple.label = cmax + 1;
+      _max_sens[a] = pred > cmax ? unused : base.sensitivity(*ec);
+    }
+  }
+
+  for (size_t a = 0; a < num_actions; ++a)
+  {
+    const float pred = _preds[a];
+    const float sens = _min_sens[a];
+    if (pred < cmin || std::isnan(sens) || std::isinf(sens)) { min_costs[a] = cmin; }
+    else
+    {
+      const float fhat = pred - cmin + 1;
+      const float w = closed_form ? closed_form_weight(fhat, delta, sens) : binary_search(fhat, delta, sens);
+      min_costs[a] = (std::min)((std::max)(pred - sens * w, cmin), cmax);
+    }
+  }
+
+  if (min_only) { return; }
+  for (size_t a = 0; a < num_actions; ++a)
+  {
+    const float pred = _preds[a];
+    const float sens = _max_sens[a];
+    if (pred > cmax || std::isnan(sens) || std::isinf(sens)) { max_costs[a] = cmax; }
+    else
+    {
+      const float fhat = cmax + 1 - pred;
+      const float w = closed_form ? closed_form_weight(fhat, delta, sens) : binary_search(fhat, delta, sens);
+      max_costs[a] = (std::max)((std::min)(pred + sens * w, cmax), cmin);
+    }
+  }
+}
+}  // namespace cb_explore_adf
+}  // namespace VW
@@ -0,0 +1,42 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+#pragma once
+
+#include "learner.h"
+#include "vw_fwd.h"
+
+#include <vector>
+
+namespace VW
+{
+namespace cb_explore_adf
+{
+// Largest importance weight w such that w * (fhat^2 - (fhat - w * sens)^2) <= delta, found by the binary search
+// described at the end of Section 7.1 in https://arxiv.org/pdf/1703.01014.pdf.
+float binary_search(float fhat, float delta, float sens, float tol = 1e-6);
+
+// Solves the same problem in closed form. With u = w * sens / fhat the feasible region is u^3 - 2u^2 + c >= 0,
+// c = delta * sens / fhat^3, bounded by the root of the cubic in [0, 1] given by the trigonometric formula.
+float closed_form_weight(float fhat, float delta, float sens);
+
+// Range of costs each action can take given the data seen so far, shared by RegCB and SquareCB elimination.
+class cost_ranges
+{
+public:
+  // examples[0]->pred.a_s must hold the regressor predictions. Fills min_costs and max_costs indexed by action.
+  // All sensitivities are gathered first, then the importance weights are solved in one loop, by binary search unless
+  // closed_form is set.
+  void compute(float delta, VW::LEARNER::multi_learner& base, VW::multi_ex& examples, float min_cb_cost,
+      float max_cb_cost, bool min_only, bool closed_form = false);
+
+  std::vector<float> min_costs;
+  std::vector<float> max_costs;
+
+private:
+  std::vector<float> _preds;
+  std::vector<float> _min_sens;
+  std::vector<float> _max_sens;
+};
+}  // namespace cb_explore_adf
+}  // namespace VW
@@ -54,6 +54,7 @@ private:
   COST_SENSITIVE::label _cs_labels_2;
   std::vector<COST_SENSITIVE::label> _prepped_cs_labels;
   std::vector<CB::label> _cb_labels;
+  std::vector<VW::polyprediction> _cover_preds;
 
 public:
   cb_explore_adf_cover(size_t cover_size, float psi, bool nounif, float epsilon, bool epsilon_decay, bool first_only,
@@ -135,7 +136,7 @@ void cb_explore_adf_cover::predict_or_learn_impl(VW::LEARNER::multi_learner& bas
       ? std::min(_epsilon / num_actions, _epsilon / static_cast<float>(std::sqrt(_counter * num_actions)))
       : _epsilon / num_actions;
 
-  _action_probs.clear();
+  _action_probs.clear_noshrink();
   for (uint32_t i = 0; i < num_actions; i++) { _action_probs.push_back({i, 0.}); }
   _scores.clear();
   for (uint32_t i = 0; i < num_actions; i++) { _scores.push_back(preds[i].score); }
@@ -152,6 +153,13 @@ void cb_explore_adf_cover::predict_or_learn_impl(VW::LEARNER::multi_learner& bas
   }
 
   float norm = min_prob * num_actions + (additive_probability - min_prob);
+  if (!is_learn && _cover_size > 1)
+  {
+    // the policies do not depend on each other when predicting, so they are predicted in one pass
+    _cover_preds.resize(_cover_size - 1);
+    GEN_CS::cs_ldf_multipredict(*(_cs_ldf_learner), examples, _cb_labels, _cs_labels, _prepped_cs_labels,
+        examples[0]->ft_offset, 2, _cover_size - 1, _cover_preds.data());
+  }
   for (size_t i = 1; i < _cover_size; i++)
   {
     // Create costs of each action based on online cover
@@ -173,31 +181,27 @@ void cb_explore_adf_cover::predict_or_learn_impl(VW::LEARNER::multi_learner& bas
       GEN_CS::cs_ldf_learn_or_predict<true>(*(_cs_ldf_learner), examples, _cb_labels, _cs_labels_2, _prepped_cs_labels,
           true, examples[0]->ft_offset, i + 1);
     }
-    else
-    {
-      GEN_CS::cs_ldf_learn_or_predict<false>(*(_cs_ldf_learner), examples, _cb_labels, _cs_labels, _prepped_cs_labels,
-          false, examples[0]->ft_offset, i + 1);
-    }
+    const auto& policy_preds = is_learn ? preds : _cover_preds[i - 1].a_s;
 
-    for (uint32_t j = 0; j < num_actions; j++) { _scores[j] += preds[j].score; }
+    for (uint32_t j = 0; j < num_actions; j++) { _scores[j] += policy_preds[j].score; }
     if (!_first_only)
     {
-      size_t tied_actions = fill_tied(preds);
+      size_t tied_actions = fill_tied(policy_preds);
       const float add_prob = additive_probability / tied_actions;
       for (size_t j = 0; j < tied_actions; ++j)
       {
-        if (_action_probs[preds[j].action].score < min_prob)
-        { norm += (std::max)(0.f, add_prob - (min_prob - _action_probs[preds[j].action].score)); }
+        if (_action_probs[policy_preds[j].action].score < min_prob)
+        { norm += (std::max)(0.f, add_prob - (min_prob - _action_probs[policy_preds[j].action].score)); }
         else
         {
           norm += add_prob;
         }
-        _action_probs[preds[j].action].score += add_prob;
+        _action_probs[policy_preds[j].action].score += add_prob;
       }
     }
     else
     {
-      uint32_t action = preds[0].action;
+      uint32_t action = policy_preds[0].action;
       if (_action_probs[action].score < min_prob)
       { norm += (std::max)(0.f, additive_probability - (min_prob - _action_probs[action].score)); }
       else
@@ -8,6 +8,7 @@
 #include "cb.h"
 #include "cb_adf.h"
 #include "cb_explore.h"
+#include "cb_explore_adf_cost_ranges.h"
 #include "config/options.h"
 #include "explore.h"
 #include "gen_cs_example.h"
@@ -26,8 +27,6 @@
 // All exploration algorithms return a vector of id, probability tuples, sorted in order of scores. The probabilities
 // are the probability with which each action should be replaced to the top of the list.
 
-#define B_SEARCH_MAX_ITER 20
-
 using namespace VW::LEARNER;
 
 namespace VW
@@ -46,15 +45,11 @@ private:
   float _min_cb_cost;
   float _max_cb_cost;
 
-  std::vector<float> _min_costs;
-  std::vector<float> _max_costs;
+  cost_ranges _cost_ranges;
+  ACTION_SCORE::action_scores _learn_preds;
 
   VW::version_struct _model_file_version;
 
-  // for backing up cb example data when computing sensitivities
-  std::vector<ACTION_SCORE::action_scores> _ex_as;
-  std::vector<std::vector<CB::cb_class>> _ex_costs;
-
 public:
   cb_explore_adf_regcb(bool regcbopt, float c0, bool first_only, float min_cb_cost, float max_cb_cost,
       VW::version_struct model_file_version);
@@ -68,9 +63,6 @@ public:
 private:
   void predict_impl(multi_learner& base, multi_ex& examples);
   void learn_impl(multi_learner& base, multi_ex& examples);
-
-  void get_cost_ranges(float delta, multi_learner& base, multi_ex& examples, bool min_only);
-  float binary_search(float fhat, float delta, float sens, float tol = 1e-6);
 };
 
 cb_explore_adf_regcb::cb_explore_adf_regcb(bool regcbopt, float c0, bool first_only, float min_cb_cost,
@@ -85,91 +77,6 @@ cb_explore_adf_regcb::cb_explore_adf_regcb(bool regcbopt, float c0, bool first_o
 {
 }
 
-// TODO: same as cs_active.cc, move to shared place
-float cb_explore_adf_regcb::binary_search(float fhat, float delta, float sens, float tol)
-{
-  const float maxw = (std::min)(fhat / sens, FLT_MAX);
-
-  if (maxw * fhat * fhat <= delta) { return maxw; }
-
-  float l = 0;
-  float u = maxw;
-  float w, v;
-
-  for (int iter = 0; iter < B_SEARCH_MAX_ITER; iter++)
-  {
-    w = (u + l) / 2.f;
-    v = w * (fhat * fhat - (fhat - sens * w) * (fhat - sens * w)) - delta;
-    if (v > 0) { u = w; }
-    else
-    {
-      l = w;
-    }
-    if (std::fabs(v) <= tol || u - l <= tol) { break; }
-  }
-
-  return l;
-}
-
-void cb_explore_adf_regcb::get_cost_ranges(float delta, multi_learner& base, multi_ex& examples, bool min_only)
-{
-  const size_t num_actions = examples[0]->pred.a_s.size();
-  _min_costs.resize(num_actions);
-  _max_costs.resize(num_actions);
-
-  _ex_as.clear();
-  _ex_costs.clear();
-
-  // backup cb example data
-  for (const auto& ex : examples)
-  {
-    _ex_as.push_back(ex->pred.a_s);
-    _ex_costs.push_back(ex->l.cb.costs);
-  }
-
-  // set regressor predictions
-  for (const auto& as : _ex_as[0]) { examples[as.action]->pred.scalar = as.score; }
-
-  const float cmin = _min_cb_cost;
-  const float cmax = _max_cb_cost;
-
-  for (size_t a = 0; a < num_actions; ++a)
-  {
-    example* ec = examples[a];
-    ec->l.simple.label = cmin - 1;
-    float sens = base.sensitivity(*ec);
-    float w = 0;  // importance weight
-
-    if (ec->pred.scalar < cmin || std::isnan(sens) || std::isinf(sens)) { _min_costs[a] = cmin; }
-    else
-    {
-      w = binary_search(ec->pred.scalar - cmin + 1, delta, sens);
-      _min_costs[a] = (std::max)(ec->pred.scalar - sens * w, cmin);
-      if (_min_costs[a] > cmax) { _min_costs[a] = cmax; }
-    }
-
-    if (!min_only)
-    {
-      ec->l.simple.label = cmax + 1;
-      sens = base.sensitivity(*ec);
-      if (ec->pred.scalar > cmax || std::isnan(sens) || std::isinf(sens)) { _max_costs[a] = cmax; }
-      else
-      {
-        w = binary_search(cmax + 1 - ec->pred.scalar, delta, sens);
-        _max_costs[a] = (std::min)(ec->pred.scalar + sens * w, cmax);
-        if (_max_costs[a] < cmin) { _max_costs[a] = cmin; }
-      }
-    }
-  }
-
-  // reset cb example data
-  for (size_t i = 0; i < examples.size(); ++i)
-  {
-    examples[i]->pred.a_s = _ex_as[i];
-    examples[i]->l.cb.costs = _ex_costs[i];
-  }
-}
-
 void cb_explore_adf_regcb::predict_impl(multi_learner& base, multi_ex& examples)
 {
   multiline_learn_or_predict<false>(base, examples, examples[0]->ft_offset);
@@ -180,7 +87,7 @@ void cb_explore_adf_regcb::predict_impl(multi_learner& base, multi_ex& examples)
   // threshold on empirical loss difference
   const float delta =
       _c0 * std::log(static_cast<float>(num_actions * _counter)) * static_cast<float>(std::pow(max_range, 2));
-  get_cost_ranges(delta, base, examples, /*min_only=*/_regcbopt);
+  _cost_ranges.compute(delta, base, examples, _min_cb_cost, _max_cb_cost, /*min_only=*/_regcbopt);
 
   if (_regcbopt)  // optimistic variant
   {
@@ -188,15 +95,16 @@ void cb_explore_adf_regcb::predict_impl(multi_learner& base, multi_ex& examples)
     size_t a_opt = 0;  // optimistic action
     for (size_t a = 0; a < num_actions; ++a)
     {
-      if (_min_costs[a] < min_cost)
+      if (_cost_ranges.min_costs[a] < min_cost)
       {
-        min_cost = _min_costs[a];
+        min_cost = _cost_ranges.min_costs[a];
         a_opt = a;
       }
     }
     for (size_t i = 0; i < preds.size(); ++i)
     {
-      if (preds[i].action == a_opt || (!_first_only && _min_costs[preds[i].action] == min_cost)) { preds[i].score = 1; }
+      if (preds[i].action == a_opt || (!_first_only && _cost_ranges.min_costs[preds[i].action] == min_cost))
+      { preds[i].score = 1; }
       else
       {
         preds[i].score = 0;
@@ -208,11 +116,11 @@ void cb_explore_adf_regcb::predict_impl(multi_learner& base, multi_ex& examples)
     float min_max_cost = FLT_MAX;
     for (size_t a = 0; a < num_actions; ++a)
     {
-      if (_max_costs[a] < min_max_cost) { min_max_cost = _max_costs[a]; }
+      if (_cost_ranges.max_costs[a] < min_max_cost) { min_max_cost = _cost_ranges.max_costs[a]; }
     }
     for (size_t i = 0; i < preds.size(); ++i)
     {
-      if (_min_costs[preds[i].action] <= min_max_cost) { preds[i].score = 1; }
+      if (_cost_ranges.min_costs[preds[i].action] <= min_max_cost) { preds[i].score = 1; }
       else
       {
         preds[i].score = 0;
@@ -226,7 +134,9 @@ void cb_explore_adf_regcb::predict_impl(multi_learner& base, multi_ex& examples)
 
 void cb_explore_adf_regcb::learn_impl(multi_learner& base, multi_ex& examples)
 {
-  v_array<ACTION_SCORE::action_score> preds = std::move(examples[0]->pred.a_s);
+  // the prediction is parked in a member so that learn writes into a buffer that is kept across calls
+  std::swap(examples[0]->pred.a_s, _learn_preds);
+  examples[0]->pred.a_s.clear_noshrink();
   for (size_t i = 0; i < examples.size() - 1; ++i)
   {
     CB::label& ld = examples[i]->l.cb;
@@ -238,7 +148,7 @@ void cb_explore_adf_regcb::learn_impl(multi_learner& base, multi_ex& examples)
 
   multiline_learn_or_predict<true>(base, examples, examples[0]->ft_offset);
   ++_counter;
-  examples[0]->pred.a_s = std::move(preds);
+  std::swap(examples[0]->pred.a_s, _learn_preds);
 }
 
 void cb_explore_adf_regcb::save_load(io_buf& io, bool read, bool text)
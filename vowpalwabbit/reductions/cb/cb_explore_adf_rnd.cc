@@ -52,6 +52,7 @@ private:
 
   std::vector<float> bonuses;
   std::vector<float> initials;
+  std::vector<VW::polyprediction> rnd_preds;
 
   CB::cb_class save_class;
 
@@ -61,7 +62,7 @@ private:
   float get_initial_prediction(example*);
   void get_initial_predictions(multi_ex&, uint32_t);
   void zero_bonuses(multi_ex&);
-  void accumulate_bonuses(multi_ex&);
+  void accumulate_bonuses(const v_array<ACTION_SCORE::action_score>&);
   void finish_bonuses();
   void compute_ci(v_array<ACTION_SCORE::action_score>&, float);
 
@@ -94,9 +95,8 @@ public:
 
 void cb_explore_adf_rnd::zero_bonuses(multi_ex& examples) { bonuses.assign(examples.size(), 0.f); }
 
-void cb_explore_adf_rnd::accumulate_bonuses(multi_ex& examples)
+void cb_explore_adf_rnd::accumulate_bonuses(const v_array<ACTION_SCORE::action_score>& preds)
 {
-  const auto& preds = examples[0]->pred.a_s;
   for (const auto& p : preds)
   {
     float score = p.score - initials[p.action];
@@ -235,12 +235,26 @@ void cb_explore_adf_rnd::predict_or_learn_impl(multi_learner& base, multi_ex& ex
   auto restore_guard = VW::scope_exit([this, &examples] { this->restore_labels<is_learn>(examples); });
 
   zero_bonuses(examples);
-  for (uint32_t id = 0; id < numrnd; ++id)
+  if (is_learn)
+  {
+    for (uint32_t id = 0; id < numrnd; ++id)
+    {
+      get_initial_predictions(examples, 1 + id);
+      make_fake_rnd_labels<is_learn>(examples);
+      base_learn_or_predict<is_learn>(base, examples, 1 + id);
+      accumulate_bonuses(examples[0]->pred.a_s);
+    }
+  }
+  else
   {
-    get_initial_predictions(examples, 1 + id);
-    make_fake_rnd_labels<is_learn>(examples);
-    base_learn_or_predict<is_learn>(base, examples, 1 + id);
-    accumulate_bonuses(examples);
+    // without fake labels the predictions of the random networks are independent, they are made in one pass
+    rnd_preds.resize(numrnd);
+    base.multipredict(examples, 1, numrnd, rnd_preds.data(), false);
+    for (uint32_t id = 0; id < numrnd; ++id)
+    {
+      get_initial_predictions(examples, 1 + id);
+      accumulate_bonuses(rnd_preds[id].a_s);
+    }
   }
   finish_bonuses();
 
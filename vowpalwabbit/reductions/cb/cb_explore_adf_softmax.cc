@@ -53,7 +53,9 @@ void cb_explore_adf_softmax::predict_or_learn_impl(VW::LEARNER::multi_learner& b
   exploration::generate_softmax(
       -_lambda, begin_scores(preds), end_scores(preds), begin_scores(preds), end_scores(preds));
 
-  exploration::enforce_minimum_probability(_epsilon, true, begin_scores(preds), end_scores(preds));
+  // With no epsilon the pass below leaves the softmax pmf unchanged.
+  if (_epsilon > 0.f)
+  { exploration::enforce_minimum_probability(_epsilon, true, begin_scores(preds), end_scores(preds)); }
 }
 
 VW::LEARNER::base_learner* setup(VW::setup_base_i& stack_builder)
@@ -8,6 +8,7 @@
 #include "cb.h"
 #include "cb_adf.h"
 #include "cb_explore.h"
+#include "cb_explore_adf_cost_ranges.h"
 #include "config/options.h"
 #include "explore.h"
 #include "gen_cs_example.h"
@@ -30,8 +31,6 @@ with the VW learner as the base algorithm.
 // All exploration algorithms return a vector of id, probability tuples, sorted in order of scores. The probabilities
 // are the probability with which each action should be replaced to the top of the list.
 
-#define B_SEARCH_MAX_ITER 20
-
 using namespace VW::LEARNER;
 
 namespace VW
@@ -54,15 +53,11 @@ private:
   float _min_cb_cost;
   float _max_cb_cost;
 
-  std::vector<float> _min_costs;
-  std::vector<float> _max_costs;
+  cost_ranges _cost_ranges;
+  ACTION_SCORE::action_scores _learn_preds;
 
   VW::version_struct _model_file_version;
 
-  // for backing up cb example data when computing sensitivities
-  std::vector<ACTION_SCORE::action_scores> _ex_as;
-  std::vector<std::vector<CB::cb_class>> _ex_costs;
-
 public:
   cb_explore_adf_squarecb(float gamma_scale, float gamma_exponent, bool elim, float c0, float min_cb_cost,
       float max_cb_cost, VW::version_struct model_file_version);
@@ -72,10 +67,6 @@ public:
   void predict(multi_learner& base, multi_ex& examples);
   void learn(multi_learner& base, multi_ex& examples);
   void save_load(io_buf& io, bool read, bool text);
-
-private:
-  void get_cost_ranges(float delta, multi_learner& base, multi_ex& examples, bool min_only);
-  float binary_search(float fhat, float delta, float sens, float tol = 1e-6);
 };
 
 cb_explore_adf_squarecb::cb_explore_adf_squarecb(float gamma_scale, float gamma_exponent, bool elim, float c0,
@@ -91,104 +82,6 @@ cb_explore_adf_squarecb::cb_explore_adf_squarecb(float gamma_scale, float gamma_
 {
 }
 
-// TODO: same as cs_active.cc and cb_explore_adf_regcb.cc, move to shared place
-float cb_explore_adf_squarecb::binary_search(float fhat, float delta, float sens, float tol)
-{
-  /*
-     Binary search to find the largest weight w such that w*(fhat^2 - (fhat - w*sens)^2) \leq delta.
-     Implements binary search procedure described at the end of Section 7.1 in https://arxiv.org/pdf/1703.01014.pdf.
-  */
-
-  // We are always guaranteed that the solution to the problem above lies in (0, maxw), as long as fhat \geq 0.
-  const float maxw = (std::min)(fhat / sens, FLT_MAX);
-
-  // If the objective value for maxw satisfies the delta constraint, we can just take this and skip the binary search.
-  if (maxw * fhat * fhat <= delta) { return maxw; }
-
-  // Upper and lower bounds on w for binary search.
-  float l = 0;
-  float u = maxw;
-  // Binary search variable.
-  float w;
-  // Value for w.
-  float v;
-
-  // Standard binary search given the objective described above.
-  for (int iter = 0; iter < B_SEARCH_MAX_ITER; iter++)
-  {
-    w = (u + l) / 2.f;
-    v = w * (fhat * fhat - (fhat - sens * w) * (fhat - sens * w)) - delta;
-    if (v > 0) { u = w; }
-    else
-    {
-      l = w;
-    }
-    if (std::fabs(v) <= tol || u - l <= tol) { break; }
-  }
-
-  return l;
-}
-
-// TODO: Same as cb_explore_adf_regcb.cc
-void cb_explore_adf_squarecb::get_cost_ranges(float delta, multi_learner& base, multi_ex& examples, bool min_only)
-{
-  const size_t num_actions = examples[0]->pred.a_s.size();
-  _min_costs.resize(num_actions);
-  _max_costs.resize(num_actions);
-
-  _ex_as.clear();
-  _ex_costs.clear();
-
-  // backup cb example data
-  for (const auto& ex : examples)
-  {
-    _ex_as.push_back(ex->pred.a_s);
-    _ex_costs.push_back(ex->l.cb.costs);
-  }
-
-  // set regressor predictions
-  for (const auto& as : _ex_as[0]) { examples[as.action]->pred.scalar = as.score; }
-
-  const float cmin = _min_cb_cost;
-  const float cmax = _max_cb_cost;
-
-  for (size_t a = 0; a < num_actions; ++a)
-  {
-    example* ec = examples[a];
-    ec->l.simple.label = cmin - 1;
-    float sens = base.sensitivity(*ec);
-    float w = 0;  // importance weight
-
-    if (ec->pred.scalar < cmin || std::isnan(sens) || std::isinf(sens)) { _min_costs[a] = cmin; }
-    else
-    {
-      w = binary_search(ec->pred.scalar - cmin + 1, delta, sens);
-      _min_costs[a] = (std::max)(ec->pred.scalar - sens * w, cmin);
-      if (_min_costs[a] > cmax) { _min_costs[a] = cmax; }
-    }
-
-    if (!min_only)
-    {
-      ec->l.simple.label = cmax + 1;
-      sens = base.sensitivity(*ec);
-      if (ec->pred.scalar > cmax || std::isnan(sens) || std::isinf(sens)) { _max_costs[a] = cmax; }
-      else
-      {
-        w = binary_search(cmax + 1 - ec->pred.scalar, delta, sens);
-        _max_costs[a] = (std::min)(ec->pred.scalar + sens * w, cmax);
-        if (_max_costs[a] < cmin) { _max_costs[a] = cmin; }
-      }
-    }
-  }
-
-  // reset cb example data
-  for (size_t i = 0; i < examples.size(); ++i)
-  {
-    examples[i]->pred.a_s = _ex_as[i];
-    examples[i]->l.cb.costs = _ex_costs[i];
-  }
-}
-
 void cb_explore_adf_squarecb::predict(multi_learner& base, multi_ex& examples)
 {
   multiline_learn_or_predict<false>(base, examples, examples[0]->ft_offset);
@@ -233,12 +126,12 @@ void cb_explore_adf_squarecb::predict(multi_learner& base, multi_ex& examples)
   }
   else  // elimination variant
   {
-    get_cost_ranges(delta, base, examples, /*min_only=*/false);
+    _cost_ranges.compute(delta, base, examples, _min_cb_cost, _max_cb_cost, /*min_only=*/false);
 
     float min_max_cost = FLT_MAX;
     for (size_t a = 0; a < num_actions; ++a)
     {
-      if (_max_costs[a] < min_max_cost) { min_max_cost = _max_costs[a]; }
+      if (_cost_ranges.max_costs[a] < min_max_cost) { min_max_cost = _cost_ranges.max_costs[a]; }
     }
 
     size_t a_min = 0;
@@ -247,7 +140,7 @@ void cb_explore_adf_squarecb::predict(multi_learner& base, multi_ex& examples)
     // Compute plausible / surviving actions.
     for (size_t a = 0; a < num_actions; ++a)
     {
-      if (preds[a].score < min_cost && _min_costs[preds[a].action] <= min_max_cost)
+      if (preds[a].score < min_cost && _cost_ranges.min_costs[preds[a].action] <= min_max_cost)
       {
         a_min = a;
         min_cost = preds[a].score;
@@ -259,7 +152,7 @@ void cb_explore_adf_squarecb::predict(multi_learner& base, multi_ex& examples)
     // Compute probabilities for surviving actions using SquareCB rule.
     for (size_t a = 0; a < num_actions; ++a)
     {
-      if (_min_costs[preds[a].action] > min_max_cost) { preds[a].score = 0; }
+      if (_cost_ranges.min_costs[preds[a].action] > min_max_cost) { preds[a].score = 0; }
       else
       {
         if (a == a_min) { continue; }
@@ -274,7 +167,9 @@ void cb_explore_adf_squarecb::predict(multi_learner& base, multi_ex& examples)
 
 void cb_explore_adf_squarecb::learn(multi_learner& base, multi_ex& examples)
 {
-  v_array<ACTION_SCORE::action_score> preds = std::move(examples[0]->pred.a_s);
+  // the prediction is parked in a member so that learn writes into a buffer that is kept across calls
+  std::swap(examples[0]->pred.a_s, _learn_preds);
+  examples[0]->pred.a_s.clear_noshrink();
   for (size_t i = 0; i < examples.size() - 1; ++i)
   {
     CB::label& ld = examples[i]->l.cb;
@@ -286,7 +181,7 @@ void cb_explore_adf_squarecb::learn(multi_learner& base, multi_ex& examples)
 
   multiline_learn_or_predict<true>(base, examples, examples[0]->ft_offset);
   ++_counter;
-  examples[0]->pred.a_s = std::move(preds);
+  std::swap(examples[0]->pred.a_s, _learn_preds);
 }
 
 void cb_explore_adf_squarecb::save_load(io_buf& io, bool read, bool text)
@@ -20,6 +20,7 @@
 #include <cerrno>
 #include <cfloat>
 #include <cmath>
+#include <limits>
 
 using namespace VW::LEARNER;
 using namespace COST_SENSITIVE;
@@ -42,15 +43,18 @@ struct ldf
   VW::workspace* all = nullptr;
 
   bool rank = false;
+  uint32_t rank_top_k = 0;  // only the rank_top_k best actions are sorted and printed, 0 ranks all of them
   action_scores a_s;
   uint64_t ft_offset = 0;
 
   std::vector<action_scores> stored_preds;
+  std::vector<VW::polyprediction> scalar_preds;  // per offset predictions of one example in multipredict
+  std::vector<COST_SENSITIVE::wclass*> wap_costs;
 };
 
 inline bool cmp_wclass_ptr(const COST_SENSITIVE::wclass* a, const COST_SENSITIVE::wclass* b) { return a->x < b->x; }
 
-void compute_wap_values(std::vector<COST_SENSITIVE::wclass*> costs)
+void compute_wap_values(std::vector<COST_SENSITIVE::wclass*>& costs)
 {
   std::sort(costs.begin(), costs.end(), cmp_wclass_ptr);
   costs[0]->wap_value = 0.;
@@ -124,6 +128,27 @@ void make_single_prediction(ldf& data, single_learner& base, VW::example& ec)
   base.predict(ec);  // make a prediction
 }
 
+// Same as make_single_prediction for the count offsets of base that start at data.ft_offset. The raw predictions are
+// written to data.scalar_preds.
+void make_single_multiprediction(ldf& data, single_learner& base, VW::example& ec, size_t count)
+{
+  uint64_t old_offset = ec.ft_offset;
+
+  LabelDict::add_example_namespace_from_memory(data.label_features, ec, ec.l.cs.costs[0].class_index);
+
+  auto restore_guard = VW::scope_exit([&data, old_offset, &ec] {
+    ec.ft_offset = old_offset;
+    LabelDict::del_example_namespace_from_memory(data.label_features, ec, ec.l.cs.costs[0].class_index);
+  });
+
+  ec.l.simple = label_data{FLT_MAX};
+  ec._reduction_features.template get<simple_label_reduction_features>().reset_to_default();
+
+  ec.ft_offset = data.ft_offset;
+  if (data.scalar_preds.size() < count) { data.scalar_preds.resize(count); }
+  base.multipredict(ec, 0, count, data.scalar_preds.data(), false);
+}
+
 bool test_ldf_sequence(ldf& /*data*/, const VW::multi_ex& ec_seq, VW::io::logger& logger)
 {
   bool isTest;
@@ -151,36 +176,32 @@ void do_actual_learning_wap(ldf& data, single_learner& base, VW::multi_ex& ec_se
   VW_DBG(ec_seq) << "do_actual_learning_wap()" << std::endl;
 
   size_t K = ec_seq.size();
-  std::vector<COST_SENSITIVE::wclass*> all_costs;
-  for (const auto& example : ec_seq) { all_costs.push_back(&example->l.cs.costs[0]); }
-  compute_wap_values(all_costs);
+  data.wap_costs.clear();
+  for (const auto& example : ec_seq) { data.wap_costs.push_back(&example->l.cs.costs[0]); }
+  compute_wap_values(data.wap_costs);
 
   for (size_t k1 = 0; k1 < K; k1++)
   {
     VW::example* ec1 = ec_seq[k1];
 
-    // save original variables
-    COST_SENSITIVE::label save_cs_label = ec1->l.cs;
+    // l.simple and l.cs are separate members, learning on the simple label leaves the cost-sensitive one untouched
     label_data& simple_lbl = ec1->l.simple;
     auto& simple_red_features = ec1->_reduction_features.template get<simple_label_reduction_features>();
 
-    auto costs1 = save_cs_label.costs;
+    const auto& costs1 = ec1->l.cs.costs;
     if (costs1[0].class_index == static_cast<uint32_t>(-1)) { continue; }
 
     LabelDict::add_example_namespace_from_memory(data.label_features, *ec1, costs1[0].class_index);
 
     // Guard example state restore against throws
-    auto restore_guard = VW::scope_exit([&data, &save_cs_label, &costs1, &ec1] {
+    auto restore_guard = VW::scope_exit([&data, &costs1, &ec1] {
       LabelDict::del_example_namespace_from_memory(data.label_features, *ec1, costs1[0].class_index);
-
-      // restore original cost-sensitive label, sum of importance weights
-      ec1->l.cs = save_cs_label;
     });
 
     for (size_t k2 = k1 + 1; k2 < K; k2++)
     {
       VW::example* ec2 = ec_seq[k2];
-      auto costs2 = ec2->l.cs.costs;
+      const auto& costs2 = ec2->l.cs.costs;
 
       if (costs2[0].class_index == static_cast<uint32_t>(-1)) { continue; }
       float value_diff = std::fabs(costs2[0].wap_value - costs1[0].wap_value);
@@ -373,6 +394,11 @@ void predict_csoaa_ldf(ldf& data, single_learner& base, VW::multi_ex& ec_seq_all
  * 2) verify no labels in the middle of data
  * 3) learn_or_predict(data) with rest
  */
+size_t top_k(const ldf& data)
+{
+  return data.rank_top_k == 0 ? std::numeric_limits<size_t>::max() : static_cast<size_t>(data.rank_top_k);
+}
+
 void predict_csoaa_ldf_rank(ldf& data, single_learner& base, VW::multi_ex& ec_seq_all)
 {
   data.ft_offset = ec_seq_all[0]->ft_offset;
@@ -384,13 +410,13 @@ void predict_csoaa_ldf_rank(ldf& data, single_learner& base, VW::multi_ex& ec_se
   uint32_t K = static_cast<uint32_t>(ec_seq_all.size());
 
   /////////////////////// do prediction
-  data.a_s.clear();
+  data.a_s.clear_noshrink();
   data.stored_preds.clear();
 
   auto restore_guard = VW::scope_exit([&data, &ec_seq_all, K] {
-    std::sort(data.a_s.begin(), data.a_s.end(), VW::action_score_compare_lt);
+    VW::sort_top_k(data.a_s.begin(), data.a_s.end(), top_k(data), VW::action_score_compare_lt);
 
-    data.stored_preds[0].clear();
+    data.stored_preds[0].clear_noshrink();
     for (size_t k = 0; k < K; k++)
     {
       ec_seq_all[k]->pred.a_s = std::move(data.stored_preds[k]);
@@ -413,6 +439,25 @@ void predict_csoaa_ldf_rank(ldf& data, single_learner& base, VW::multi_ex& ec_se
   }
 }
 
+// Ranks the actions for count offsets at once, every action example is traversed a single time. pred[c].a_s receives
+// what predict_csoaa_ldf_rank would put into the first example for offset c.
+void multipredict_csoaa_ldf_rank(ldf& data, single_learner& base, VW::multi_ex& ec_seq_all, size_t count,
+    size_t /* step */, VW::polyprediction* pred, bool /* finalize_predictions */)
+{
+  if (ec_seq_all.empty()) { return; }
+  data.ft_offset = ec_seq_all[0]->ft_offset;
+
+  for (size_t c = 0; c < count; c++) { pred[c].a_s.clear_noshrink(); }
+  for (VW::example* ec : ec_seq_all)
+  {
+    make_single_multiprediction(data, base, *ec, count);
+    const uint32_t action = ec->l.cs.costs[0].class_index;
+    for (size_t c = 0; c < count; c++) { pred[c].a_s.push_back({action, data.scalar_preds[c].scalar}); }
+  }
+  for (size_t c = 0; c < count; c++)
+  { VW::sort_top_k(pred[c].a_s.begin(), pred[c].a_s.end(), top_k(data), VW::action_score_compare_lt); }
+}
+
 void global_print_newline(VW::workspace& all)
 {
   char temp[1];
@@ -507,7 +552,8 @@ void output_example(
   COST_SENSITIVE::print_update(all, COST_SENSITIVE::cs_label.test_label(ec.l), ec, ec_seq, false, predicted_class);
 }
 
-void output_rank_example(VW::workspace& all, VW::example& head_ec, bool& hit_loss, VW::multi_ex* ec_seq)
+void output_rank_example(
+    VW::workspace& all, const ldf& data, VW::example& head_ec, bool& hit_loss, VW::multi_ex* ec_seq)
 {
   const auto& costs = head_ec.l.cs.costs;
 
@@ -535,7 +581,7 @@ void output_rank_example(VW::workspace& all, VW::example& head_ec, bool& hit_los
   }
 
   for (auto& sink : all.final_prediction_sink)
-  { print_action_score(sink.get(), head_ec.pred.a_s, head_ec.tag, all.logger); }
+  { print_action_score(sink.get(), head_ec.pred.a_s, head_ec.tag, all.logger, top_k(data)); }
 
   if (all.raw_prediction != nullptr)
   {
@@ -566,7 +612,7 @@ void output_example_seq(VW::workspace& all, ldf& data, VW::multi_ex& ec_seq)
     all.sd->example_number++;
 
     bool hit_loss = false;
-    if (data.rank) { output_rank_example(all, **(ec_seq.begin()), hit_loss, &(ec_seq)); }
+    if (data.rank) { output_rank_example(all, data, **(ec_seq.begin()), hit_loss, &(ec_seq)); }
     else
     {
       for (VW::example* ec : ec_seq) { output_example(all, *ec, hit_loss, &(ec_seq), data); }
@@ -644,6 +690,10 @@ base_learner* csldf_setup(VW::setup_base_i& stack_builder)
       .add(make_option("ldf_override", ldf_override)
                .help("Override singleline or multiline from csoaa_ldf or wap_ldf, eg if stored in file"))
       .add(make_option("csoaa_rank", ld->rank).keep().help("Return actions sorted by score order"))
+      .add(make_option("rank_top_k", ld->rank_top_k)
+               .default_value(0)
+               .help("With --csoaa_rank, only sort and print the k best actions. The remaining actions are kept in the "
+                     "prediction in no particular order. 0 ranks all actions"))
       .add(make_option("probabilities", ld->is_probabilities).keep().help("Predict probabilities of all classes"));
 
   option_group_definition csldf_inner_options(
@@ -659,6 +709,17 @@ base_learner* csldf_setup(VW::setup_base_i& stack_builder)
     if (!options.add_parse_and_check_necessary(csldf_inner_options)) { return nullptr; }
   }
 
+  // Only the final ranking may be partially sorted. The exploration reductions consume every entry of the ranking and
+  // expect ties to be sorted together.
+  if (ld->rank_top_k != 0)
+  {
+    const bool ranked_output = options.was_supplied("cb_adf") ? options.was_supplied("rank_all") : ld->rank;
+    if (!ranked_output || options.was_supplied("cb_explore_adf"))
+    {
+      THROW("--rank_top_k requires --csoaa_rank or --cb_adf --rank_all and cannot be used with exploration reductions");
+    }
+  }
+
   // csoaa_ldf does logistic link manually for probabilities because the unlinked values are
   // required elsewhere. This implemenation will provide correct probabilities regardless
   // of whether --link logistic is included or not.
@@ -715,11 +776,13 @@ base_learner* csldf_setup(VW::setup_base_i& stack_builder)
   std::string name_addition;
   VW::prediction_type_t pred_type;
   void (*pred_ptr)(ldf&, single_learner&, VW::multi_ex&);
+  void (*multipred_ptr)(ldf&, single_learner&, VW::multi_ex&, size_t, size_t, VW::polyprediction*, bool) = nullptr;
   if (ld->rank)
   {
     name_addition = "-rank";
     pred_type = VW::prediction_type_t::action_scores;
     pred_ptr = predict_csoaa_ldf_rank;
+    if (!ld->is_probabilities) { multipred_ptr = multipredict_csoaa_ldf_rank; }
   }
   else if (ld->is_probabilities)
   {
@@ -735,6 +798,7 @@ base_learner* csldf_setup(VW::setup_base_i& stack_builder)
   }
 
   auto* l = make_reduction_learner(std::move(ld), pbase, learn_csoaa_ldf, pred_ptr, name + name_addition)
+                .set_multipredict(multipred_ptr)
                 .set_finish_example(finish_multiline_example)
                 .set_end_pass(end_pass)
                 .set_input_label_type(VW::label_type_t::cs)
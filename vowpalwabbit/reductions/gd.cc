@@ -23,6 +23,7 @@
 #endif
 
 #include "accumulate.h"
+#include "async_averager.h"
 #include "debug_log.h"
 #include "gd.h"
 #include "label_parser.h"
@@ -157,6 +158,8 @@ void end_pass(gd& g)
 {
   VW::workspace& all = *g.all;
 
+  // The averaged change of the last rounds is folded in before the weights are truncated and synchronized.
+  if (all.async_averager != nullptr) { all.async_averager->end_pass(); }
   if (!all.save_resume) { sync_weights(all); }
 
   if (all.all_reduce != nullptr)
@@ -123,6 +123,10 @@ void output_metrics(VW::workspace& all)
     metric_sink list_metrics;
 
     all.l->persist_metrics(list_metrics);
+#ifdef VW_LEARNER_PROFILING
+    all.l->persist_profile(list_metrics);
+#endif
+    if (all.perf_counters) { all.perf_counters->persist(list_metrics); }
 
 #ifdef BUILD_EXTERNAL_PARSER
     if (all.external_parser) { all.external_parser->persist_metrics(list_metrics); }
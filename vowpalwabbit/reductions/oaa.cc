@@ -12,9 +12,11 @@
 #include "vw.h"
 #include "vw_exception.h"
 
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
 #include <sstream>
+#include <vector>
 
 using namespace VW::config;
 
@@ -30,6 +32,9 @@ struct oaa
   uint64_t num_subsample = 0;           // for randomized subsampling, how many negatives to draw?
   uint32_t* subsample_order = nullptr;  // for randomized subsampling, in what order should we touch classes
   size_t subsample_id = 0;              // for randomized subsampling, where do we live in the list
+  uint64_t num_hard_negatives = 0;      // for randomized subsampling, how many top scoring negatives to always update
+  std::vector<uint32_t> hard_negatives;  // for randomized subsampling, scratch space to select the hard negatives
+  std::vector<bool> is_hard_negative;    // for randomized subsampling, which classes were selected as hard negatives
   int indexing = -1;                    // for 0 or 1 indexing
   VW::io::logger logger;
 
@@ -73,6 +78,10 @@ void learn_randomized(oaa& o, VW::LEARNER::single_learner& base, VW::example& ec
   ec.l.simple.label = 1.;  // truth
   ec._reduction_features.template get<simple_label_reduction_features>().reset_to_default();
 
+  // Hard negatives are ranked by the scores before this update. o.pred is only filled by predict(), which is not
+  // called before learn() when the driver skips the prediction, so score all classes here.
+  if (o.num_hard_negatives > 0) { base.multipredict(ec, 0, o.k, o.pred, false); }
+
   base.learn(ec, (ld.label + o.k - 1) % o.k);
 
   size_t prediction = ld.label;
@@ -80,14 +89,47 @@ void learn_randomized(oaa& o, VW::LEARNER::single_learner& base, VW::example& ec
 
   ec.l.simple.label = -1.;
   float weight_temp = ec.weight;
-  ec.weight *= (static_cast<float>(o.k)) / static_cast<float>(o.num_subsample);
+  const uint32_t true_class = static_cast<uint32_t>((ld.label + o.k - 1) % o.k);
+
+  // Hard negatives are the highest scoring wrong classes. They are always updated, so they keep their original
+  // importance weight, and the random negatives are drawn from the remaining classes.
+  if (o.num_hard_negatives > 0)
+  {
+    o.hard_negatives.clear();
+    for (uint32_t i = 0; i < o.k; i++)
+    {
+      if (i != true_class) { o.hard_negatives.push_back(i); }
+    }
+    const auto hard_end = o.hard_negatives.begin() + o.num_hard_negatives;
+    std::nth_element(o.hard_negatives.begin(), hard_end, o.hard_negatives.end(),
+        [&o](uint32_t a, uint32_t b) { return o.pred[a].scalar > o.pred[b].scalar; });
+    o.hard_negatives.erase(hard_end, o.hard_negatives.end());
+
+    for (uint32_t l : o.hard_negatives)
+    {
+      o.is_hard_negative[l] = true;
+      base.learn(ec, l);
+      if (ec.partial_prediction > best_partial_prediction)
+      {
+        best_partial_prediction = ec.partial_prediction;
+        prediction = l + 1;
+        if (o.indexing == 0 && prediction == o.k) { prediction = 0; }
+      }
+    }
+    ec.weight *= static_cast<float>(o.k - 1 - o.num_hard_negatives) / static_cast<float>(o.num_subsample);
+  }
+  else
+  {
+    ec.weight *= (static_cast<float>(o.k)) / static_cast<float>(o.num_subsample);
+  }
+
   size_t p = o.subsample_id;
   size_t count = 0;
   while (count < o.num_subsample)
   {
     uint32_t l = o.subsample_order[p];
     p = (p + 1) % o.k;
-    if (l == (ld.label + o.k - 1) % o.k) { continue; }
+    if (l == true_class || (o.num_hard_negatives > 0 && o.is_hard_negative[l])) { continue; }
     base.learn(ec, l);
     if (ec.partial_prediction > best_partial_prediction)
     {
@@ -97,6 +139,7 @@ void learn_randomized(oaa& o, VW::LEARNER::single_learner& base, VW::example& ec
     }
     count++;
   }
+  for (uint32_t l : o.hard_negatives) { o.is_hard_negative[l] = false; }
   o.subsample_id = p;
 
   ec.pred.multiclass = static_cast<uint32_t>(prediction);
@@ -315,6 +358,9 @@ VW::LEARNER::base_learner* oaa_setup(VW::setup_base_i& stack_builder)
   new_options.add(make_option("oaa", data->k).keep().necessary().help("One-against-all multiclass with <k> labels"))
       .add(make_option("oaa_subsample", data->num_subsample)
                .help("Subsample this number of negative examples when learning"))
+      .add(make_option("oaa_hard_negatives", data->num_hard_negatives)
+               .help("When subsampling, also learn this number of highest scoring negative classes, with random "
+                     "negatives drawn from the remaining classes"))
       .add(make_option("probabilities", probabilities).help("Predict probabilities of all classes"))
       .add(make_option("scores", scores).help("Output raw scores per class"))
       .add(make_option("indexing", data->indexing).one_of({0, 1}).keep().help("Choose between 0 or 1-indexing"));
@@ -333,11 +379,14 @@ VW::LEARNER::base_learner* oaa_setup(VW::setup_base_i& stack_builder)
   data->pred = calloc_or_throw<VW::polyprediction>(data->k);
   data->subsample_order = nullptr;
   data->subsample_id = 0;
+  if (data->num_hard_negatives > 0 && data->num_subsample == 0)
+  { THROW("--oaa_hard_negatives requires --oaa_subsample") }
   if (data->num_subsample > 0)
   {
-    if (data->num_subsample >= data->k)
+    if (data->num_subsample + data->num_hard_negatives >= data->k)
     {
       data->num_subsample = 0;
+      data->num_hard_negatives = 0;
       all.logger.err_info("oaa is turning off subsampling because parameter >= K");
     }
     else
@@ -352,6 +401,7 @@ VW::LEARNER::base_learner* oaa_setup(VW::setup_base_i& stack_builder)
         data->subsample_order[i] = data->subsample_order[j];
         data->subsample_order[j] = tmp;
       }
+      if (data->num_hard_negatives > 0) { data->is_hard_negative.resize(data->k, false); }
     }
   }
 
@@ -14,7 +14,6 @@
 #include <cstdio>
 #include <queue>
 #include <sstream>
-#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -31,6 +30,9 @@ struct node
   bool operator<(const node& r) const { return p < r.p; }
 };
 
+inline bool node_p_greater(const node& l, const node& r) { return l.p > r.p; }
+inline bool node_n_less(const node& l, const node& r) { return l.n < r.n; }
+
 struct plt
 {
   VW::workspace* all = nullptr;
@@ -42,15 +44,19 @@ struct plt
   uint32_t kary = 0;  // kary tree
 
   // for training
-  VW::v_array<float> nodes_time;                // in case of sgd, this stores individual t for each node
-  std::unordered_set<uint32_t> positive_nodes;  // container for positive nodes
-  std::unordered_set<uint32_t> negative_nodes;  // container for negative nodes
+  VW::v_array<float> nodes_time;       // in case of sgd, this stores individual t for each node
+  std::vector<uint32_t> positive_nodes;  // container for positive nodes
+  std::vector<uint32_t> negative_nodes;  // container for negative nodes
+  std::vector<bool> is_positive;         // bitset over all tree nodes, set for nodes in positive_nodes
 
   // for prediction
   float threshold = 0.f;
   uint32_t top_k = 0;
+  uint32_t beam_size = 0;                      // if > 0, top-k prediction uses level-wise beam search
   std::vector<VW::polyprediction> node_preds;  // for storing results of base.multipredict
   std::vector<node> node_queue;                // container for queue used for both types of predictions
+  std::vector<node> next_level;                // next frontier for beam search
+  std::vector<node> leaves;                    // leaves reached during beam search
 
   // for measuring predictive performance
   std::unordered_set<uint32_t> true_labels;
@@ -98,14 +104,13 @@ void learn(plt& p, single_learner& base, VW::example& ec)
     for (auto label : multilabels.label_v)
     {
       uint32_t tn = label + p.ti;
-      if (tn < p.t)
+      // walk up to the root, stopping early once we join a path that is already marked
+      while (tn < p.t && !p.is_positive[tn])
       {
-        p.positive_nodes.insert(tn);
-        while (tn > 0)
-        {
-          tn = static_cast<uint32_t>(std::floor(static_cast<float>(tn - 1) / p.kary));
-          p.positive_nodes.insert(tn);
-        }
+        p.is_positive[tn] = true;
+        p.positive_nodes.push_back(tn);
+        if (tn == 0) { break; }
+        tn = (tn - 1) / p.kary;
       }
     }
     if (multilabels.label_v.back() >= p.k)
@@ -114,30 +119,32 @@ void learn(plt& p, single_learner& base, VW::example& ec)
           "label {0} is not in {{0,{1}}} This won't work right.", multilabels.label_v.back(), p.k - 1);
     }
 
-    for (auto& n : p.positive_nodes)
+    for (auto n : p.positive_nodes)
     {
       if (n < p.ti)
       {
-        for (uint32_t i = 1; i <= p.kary; ++i)
+        // children of a node are contiguous, and every child has a single parent so no duplicates are possible
+        uint32_t n_child = p.kary * n + 1;
+        for (uint32_t i = 0; i < p.kary && n_child < p.t; ++i, ++n_child)
         {
-          uint32_t n_child = p.kary * n + i;
-          if (n_child < p.t && p.positive_nodes.find(n_child) == p.positive_nodes.end())
-          { p.negative_nodes.insert(n_child); }
+          if (!p.is_positive[n_child]) { p.negative_nodes.push_back(n_child); }
         }
       }
     }
+
+    for (auto n : p.positive_nodes) { p.is_positive[n] = false; }
   }
   else
   {
-    p.negative_nodes.insert(0);
+    p.negative_nodes.push_back(0);
   }
 
   ec.l.simple = {1.f};
   ec._reduction_features.template get<simple_label_reduction_features>().reset_to_default();
-  for (auto& n : p.positive_nodes) { learn_node(p, n, base, ec); }
+  for (auto n : p.positive_nodes) { learn_node(p, n, base, ec); }
 
   ec.l.simple.label = -1.f;
-  for (auto& n : p.negative_nodes) { learn_node(p, n, base, ec); }
+  for (auto n : p.negative_nodes) { learn_node(p, n, base, ec); }
 
   p.all->sd->t = t;
   p.all->sd->weighted_holdout_examples = weighted_holdout_examples;
@@ -222,7 +229,49 @@ void predict(plt& p, single_learner& base, VW::example& ec)
     }
   }
 
-  // top-k prediction
+  // top-k prediction with level-wise beam search
+  else if (p.beam_size > 0)
+  {
+    p.leaves.clear();
+    p.node_queue.push_back({0, predict_node(0, base, ec)});  // here queue is used as the current frontier
+
+    while (!p.node_queue.empty())
+    {
+      // expand the frontier in node order, so the weights of all children are visited in increasing offsets
+      std::sort(p.node_queue.begin(), p.node_queue.end(), node_n_less);
+      p.next_level.clear();
+      for (const auto& node : p.node_queue)
+      {
+        uint32_t n_child = p.kary * node.n + 1;
+        ec.l.simple = {FLT_MAX};
+        ec._reduction_features.template get<simple_label_reduction_features>().reset_to_default();
+        base.multipredict(ec, n_child, p.kary, p.node_preds.data(), false);
+
+        for (uint32_t i = 0; i < p.kary; ++i, ++n_child)
+        {
+          float cp_child = node.p * (1.0f / (1.0f + std::exp(-p.node_preds[i].scalar)));
+          if (n_child < p.ti) { p.next_level.push_back({n_child, cp_child}); }
+          else if (n_child < p.t)
+          {
+            p.leaves.push_back({n_child, cp_child});
+          }
+        }
+      }
+
+      if (p.next_level.size() > p.beam_size)
+      {
+        std::nth_element(p.next_level.begin(), p.next_level.begin() + p.beam_size, p.next_level.end(), node_p_greater);
+        p.next_level.resize(p.beam_size);
+      }
+      std::swap(p.node_queue, p.next_level);
+    }
+
+    const size_t num_preds = std::min(p.leaves.size(), static_cast<size_t>(p.top_k));
+    std::partial_sort(p.leaves.begin(), p.leaves.begin() + num_preds, p.leaves.end(), node_p_greater);
+    for (size_t i = 0; i < num_preds; ++i) { preds.label_v.push_back(p.leaves[i].n - p.ti); }
+  }
+
+  // top-k prediction with exact best-first search
   else
   {
     p.node_queue.push_back({0, predict_node(0, base, ec)});  // here queue is used as priority queue
@@ -256,17 +305,17 @@ void predict(plt& p, single_learner& base, VW::example& ec)
         if (preds.label_v.size() >= p.top_k) { break; }
       }
     }
+  }
 
-    // calculate p@
-    if (p.true_labels.size() > 0)
+  // calculate p@
+  if (!threshold && p.true_labels.size() > 0)
+  {
+    for (size_t i = 0; i < p.top_k && i < preds.label_v.size(); ++i)
     {
-      for (size_t i = 0; i < p.top_k; ++i)
-      {
-        if (p.true_labels.count(preds.label_v[i])) { ++p.tp_at[i]; }
-      }
-      ++p.ec_count;
-      p.true_count += static_cast<uint32_t>(p.true_labels.size());
+      if (p.true_labels.count(preds.label_v[i])) { ++p.tp_at[i]; }
     }
+    ++p.ec_count;
+    p.true_count += static_cast<uint32_t>(p.true_labels.size());
   }
 
   p.node_queue.clear();
@@ -345,12 +394,19 @@ base_learner* plt_setup(VW::setup_base_i& stack_builder)
                .help("Predict labels with conditional marginal probability greater than <thr> threshold"))
       .add(make_option("top_k", tree->top_k)
                .default_value(0)
-               .help("Predict top-<k> labels instead of labels above threshold"));
+               .help("Predict top-<k> labels instead of labels above threshold"))
+      .add(make_option("plt_beam_size", tree->beam_size)
+               .default_value(0)
+               .help("Use level-wise beam search of width <b> for top-k prediction instead of exact best-first "
+                     "search (0 = exact search)"));
 
   if (!options.add_parse_and_check_necessary(new_options)) { return nullptr; }
 
   tree->all = &all;
 
+  if (tree->beam_size > 0 && tree->beam_size < tree->top_k)
+  { THROW("--plt_beam_size must be at least --top_k, got " << tree->beam_size << " < " << tree->top_k); }
+
   // calculate number of tree nodes
   const double a = std::pow(tree->kary, std::floor(std::log(tree->k) / std::log(tree->kary)));
   const double b = tree->k - a;
@@ -365,7 +421,11 @@ base_learner* plt_setup(VW::setup_base_i& stack_builder)
     *(all.trace_message) << "PLT k = " << tree->k << "\nkary_tree = " << tree->kary << std::endl;
     if (!all.training)
     {
-      if (tree->top_k > 0) { *(all.trace_message) << "top_k = " << tree->top_k << std::endl; }
+      if (tree->top_k > 0)
+      {
+        *(all.trace_message) << "top_k = " << tree->top_k << std::endl;
+        if (tree->beam_size > 0) { *(all.trace_message) << "plt_beam_size = " << tree->beam_size << std::endl; }
+      }
       else
       {
         *(all.trace_message) << "threshold = " << tree->threshold << std::endl;
@@ -376,6 +436,7 @@ base_learner* plt_setup(VW::setup_base_i& stack_builder)
   // resize VW::v_arrays
   tree->nodes_time.resize_but_with_stl_behavior(tree->t);
   std::fill(tree->nodes_time.begin(), tree->nodes_time.end(), all.initial_t);
+  tree->is_positive.resize(tree->t, false);
   tree->node_preds.resize(tree->kary);
   if (tree->top_k > 0) { tree->tp_at.resize_but_with_stl_behavior(tree->top_k); }
 
@@ -385,7 +446,7 @@ base_learner* plt_setup(VW::setup_base_i& stack_builder)
 
   if (tree->top_k > 0)
   {
-    name_addition = "-top_k";
+    name_addition = tree->beam_size > 0 ? "-top_k-beam" : "-top_k";
     pred_ptr = predict<false>;
   }
   else
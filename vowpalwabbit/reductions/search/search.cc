@@ -29,7 +29,12 @@
 #include <string.h>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <thread>
 // needed for printing ranges of objects (eg: all elements of a vector)
 #include <fmt/ranges.h>
 
@@ -138,7 +143,62 @@ std::ostream& operator<<(std::ostream& os, const action_cache& x)
   return os;
 }
 
+// the state of a LEARN run right before the prediction at time step t of the training trajectory, which is the same
+// for all rollouts that deviate at t or later
+struct rollout_checkpoint
+{
+  size_t t = 0;
+  float learn_loss = 0.f;
+  size_t loss_declared_cnt = 0;
+  std::vector<action_repr> ptag_to_action;
+  std::shared_ptr<void> task_state;  // what the task's save_checkpoint returned
+};
+
 void clear_memo_foreach_action(search_private& priv);
+void clear_rollout_checkpoints(search_private& priv);
+
+// threads for --search_rollout_threads. every worker rolls out on a search object of its own, so the one-step
+// deviations of a time step can run at the same time as long as they only follow the oracle.
+class rollout_workers
+{
+public:
+  rollout_workers(search& sch, size_t num_workers);
+  ~rollout_workers();
+
+  // hands the state of the LEARN phase of the current example to every worker
+  void sync(search& sch);
+  // starts the rollouts of actions [begin, end) at priv.learn_t of the main search object, continuing from
+  // checkpoint if it is not null
+  void start(
+      search_private& priv, VW::multi_ex& ec_seq, size_t begin, size_t end, const rollout_checkpoint* checkpoint);
+  // waits for the rollouts that were started
+  void wait();
+  // waits and adds the costs of the rollouts to priv.learn_losses, in action order. rethrows the error of a worker
+  void finish(search_private& priv);
+
+private:
+  void run(size_t id);
+
+  std::vector<std::unique_ptr<search>> _searches;
+  std::vector<std::thread> _threads;
+
+  std::mutex _mutex;
+  std::condition_variable _work_cv;
+  std::condition_variable _done_cv;
+  uint64_t _round = 0;
+  size_t _busy = 0;
+  bool _stop = false;
+  std::exception_ptr _error;
+
+  // set by start for the running round
+  VW::multi_ex* _ec_seq = nullptr;
+  size_t _learn_t = 0;
+  size_t _begin = 0;
+  size_t _end = 0;
+  const rollout_checkpoint* _checkpoint = nullptr;
+  std::atomic<size_t> _next_action{0};
+  std::vector<float> _losses;
+};
 
 struct search_private
 {
@@ -301,12 +361,20 @@ public:
   VW::v_array<VW::v_array<action_cache>*>
       memo_foreach_action;  // when foreach_action is on, we need to cache TRAIN trajectory actions for LEARN
 
+  size_t learn_valid_action_cnt = 0;              // how many actions there were at learn_t in the last LEARN run
+  std::unique_ptr<rollout_workers> rollout_pool;  // only with --search_rollout_threads > 1
+
+  bool use_checkpoints = false;                 // the task can continue LEARN runs from a rollout_checkpoint
+  std::vector<rollout_checkpoint> checkpoints;  // checkpoints of the current example, ordered by t
+  size_t checkpoint_t = 0;                      // time step the current run continued from
+
   ~search_private()
   {
     if (all)
     {
       for (auto& ar : ptag_to_action) { delete ar.repr; }
       clear_memo_foreach_action(*this);
+      clear_rollout_checkpoints(*this);
     }
   }
 };
@@ -320,6 +388,15 @@ void clear_memo_foreach_action(search_private& priv)
   priv.memo_foreach_action.clear();
 }
 
+void clear_rollout_checkpoints(search_private& priv)
+{
+  for (auto& checkpoint : priv.checkpoints)
+  {
+    for (auto& ar : checkpoint.ptag_to_action) { delete ar.repr; }
+  }
+  priv.checkpoints.clear();
+}
+
 search::search()
 {
   priv = &calloc_or_throw<search_private>();
@@ -677,6 +754,14 @@ void del_neighbor_features(search_private& priv, VW::multi_ex& ec_seq)
   for (size_t n = 0; n < ec_seq.size(); n++) { del_features_in_top_namespace(priv, *ec_seq[n], neighbor_namespace); }
 }
 
+// every run over an example, including each rollout of a LEARN time step, starts from a seed that only depends on
+// the example. a rollout therefore draws the same numbers no matter which thread runs it or what ran before it
+void seed_rollout_prng(search_private& priv)
+{
+  priv._random_state->set_random_state(
+      static_cast<uint32_t>(priv.read_example_last_id * 147483 + 4831921) * 2147483647);
+}
+
 void reset_search_structure(search_private& priv)
 {
   // NOTE: make sure do NOT reset priv.learn_a_idx
@@ -691,6 +776,7 @@ void reset_search_structure(search_private& priv)
   priv.should_produce_string = false;
   priv.mix_per_roll_policy = -2;
   priv.force_setup_ec_ref = false;
+  priv.checkpoint_t = 0;
   if (priv.adaptive_beta)
   {
     float x = -log1pf(-priv.alpha) * static_cast<float>(priv.total_examples_generated);
@@ -705,10 +791,7 @@ void reset_search_structure(search_private& priv)
   priv.ptag_to_action.clear();
 
   if (!priv.cb_learner)  // was: if rollout_all_actions
-  {
-    priv._random_state->set_random_state(
-        static_cast<uint32_t>(priv.read_example_last_id * 147483 + 4831921) * 2147483647);
-  }
+  { seed_rollout_prng(priv); }
 }
 
 void search_declare_loss(search_private& priv, float loss)
@@ -1687,6 +1770,7 @@ action search_predict(search_private& priv, VW::example* ecs, size_t ec_cnt, pta
   {
     action a = static_cast<action>(priv.learn_a_idx);
     priv.loss_declared_cnt = 0;
+    priv.learn_valid_action_cnt = valid_action_cnt;
 
     cdbg << "LEARN " << t << " = priv.learn_t ==> a=" << a << ", learn_a_idx=" << priv.learn_a_idx
          << " valid_action_cnt=" << valid_action_cnt << endl;
@@ -2139,6 +2223,203 @@ void advance_from_known_actions(search_private& priv)
   advance_from_known_actions(priv);
 }
 
+// called by predict right before the prediction at time step t. the first LEARN run that gets to learn_t leaves
+// a checkpoint there for the other rollouts at learn_t and for the next time steps
+void save_checkpoint(search& sch)
+{
+  search_private& priv = *sch.priv;
+  size_t t = priv.t + priv.meta_t;
+  if ((priv.state != SearchState::LEARN) || (t != priv.learn_t) || (t == 0)) { return; }
+  auto it = std::lower_bound(priv.checkpoints.begin(), priv.checkpoints.end(), t,
+      [](const rollout_checkpoint& checkpoint, size_t t) { return checkpoint.t < t; });
+  if ((it != priv.checkpoints.end()) && (it->t == t)) { return; }
+
+  rollout_checkpoint checkpoint;
+  checkpoint.t = t;
+  checkpoint.learn_loss = priv.learn_loss;
+  checkpoint.loss_declared_cnt = priv.loss_declared_cnt;
+  for (const auto& ar : priv.ptag_to_action) { checkpoint.ptag_to_action.push_back(action_repr(ar.a, ar.repr)); }
+  checkpoint.task_state = priv.task->save_checkpoint(sch);
+  priv.checkpoints.insert(it, std::move(checkpoint));
+}
+
+// the last checkpoint at or before learn_t, if any
+const rollout_checkpoint* find_checkpoint(const search_private& priv, size_t learn_t)
+{
+  auto it = std::upper_bound(priv.checkpoints.begin(), priv.checkpoints.end(), learn_t,
+      [](size_t t, const rollout_checkpoint& checkpoint) { return t < checkpoint.t; });
+  return (it == priv.checkpoints.begin()) ? nullptr : &*(it - 1);
+}
+
+// must come after reset_search_structure
+void continue_from_checkpoint(search& sch, const rollout_checkpoint& checkpoint)
+{
+  search_private& priv = *sch.priv;
+  priv.t = checkpoint.t;
+  priv.checkpoint_t = checkpoint.t;
+  priv.learn_loss = checkpoint.learn_loss;
+  priv.loss_declared_cnt = checkpoint.loss_declared_cnt;
+  for (auto& ar : priv.ptag_to_action) { delete ar.repr; }
+  priv.ptag_to_action.clear();
+  for (const auto& ar : checkpoint.ptag_to_action) { priv.ptag_to_action.push_back(action_repr(ar.a, ar.repr)); }
+  sch.checkpoint_data = checkpoint.task_state;
+}
+
+rollout_workers::rollout_workers(search& sch, size_t num_workers)
+{
+  const search_private& priv = *sch.priv;
+  for (size_t i = 0; i < num_workers; i++)
+  {
+    auto worker = VW::make_unique<search>();
+    search_private& wpriv = *worker->priv;
+    wpriv.all = priv.all;
+    // seeded by reset_search_structure before every rollout, see seed_rollout_prng
+    wpriv._random_state = std::make_shared<VW::rand_state>();
+    wpriv.pred_string = VW::make_unique<std::stringstream>();
+    wpriv.truth_string = VW::make_unique<std::stringstream>();
+    wpriv.bad_string_stream = VW::make_unique<std::stringstream>();
+    wpriv.bad_string_stream->clear(wpriv.bad_string_stream->badbit);
+    wpriv.rawOutputStringStream = VW::make_unique<std::stringstream>();
+    wpriv.mix_per_roll_policy = -2;
+    worker->task_name = sch.task_name;
+    _searches.push_back(std::move(worker));
+  }
+  for (size_t i = 0; i < num_workers; i++) { _threads.emplace_back(&rollout_workers::run, this, i); }
+}
+
+rollout_workers::~rollout_workers()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _work_cv.notify_all();
+  for (auto& thread : _threads) { thread.join(); }
+}
+
+void rollout_workers::sync(search& sch)
+{
+  const search_private& priv = *sch.priv;
+  for (auto& worker : _searches)
+  {
+    search_private& wpriv = *worker->priv;
+    wpriv.offset = priv.offset;
+    wpriv.auto_condition_features = priv.auto_condition_features;
+    wpriv.auto_hamming_loss = priv.auto_hamming_loss;
+    wpriv.examples_dont_change = priv.examples_dont_change;
+    wpriv.is_ldf = priv.is_ldf;
+    wpriv.use_action_costs = priv.use_action_costs;
+    wpriv.acset = priv.acset;
+    wpriv.history_length = priv.history_length;
+    wpriv.A = priv.A;
+    wpriv.num_learners = priv.num_learners;
+    wpriv.rollout_num_steps = priv.rollout_num_steps;
+    wpriv.rollout_method = priv.rollout_method;
+    wpriv.rollin_method = priv.rollin_method;
+    wpriv.label_is_test = priv.label_is_test;
+    wpriv.perturb_oracle = priv.perturb_oracle;
+    wpriv.force_oracle = priv.force_oracle;
+    wpriv.no_caching = priv.no_caching;
+    wpriv.adaptive_beta = priv.adaptive_beta;
+    wpriv.alpha = priv.alpha;
+    wpriv.beta = priv.beta;
+    wpriv.total_examples_generated = priv.total_examples_generated;
+    wpriv.read_example_last_id = priv.read_example_last_id;
+    wpriv.base_learner = priv.base_learner;
+    wpriv.task = priv.task;
+    wpriv.T = priv.T;
+    wpriv.train_trajectory = priv.train_trajectory;
+    priv.task->copy_task_data(sch, *worker);
+  }
+}
+
+void rollout_workers::start(
+    search_private& priv, VW::multi_ex& ec_seq, size_t begin, size_t end, const rollout_checkpoint* checkpoint)
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _ec_seq = &ec_seq;
+    _checkpoint = checkpoint;
+    _learn_t = priv.learn_t;
+    _begin = begin;
+    _end = end;
+    _next_action = begin;
+    _losses.assign(end - begin, 0.f);
+    _busy = _threads.size();
+    _round++;
+  }
+  _work_cv.notify_all();
+}
+
+void rollout_workers::wait()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _done_cv.wait(lock, [this] { return _busy == 0; });
+}
+
+void rollout_workers::finish(search_private& priv)
+{
+  wait();
+  if (_error)
+  {
+    auto error = _error;
+    _error = nullptr;
+    std::rethrow_exception(error);
+  }
+  for (size_t a = _begin; a < _end; a++)
+  {
+    cs_cost_push_back(priv.cb_learner, priv.learn_losses, static_cast<uint32_t>(priv.is_ldf ? a : a + 1),
+        _losses[a - _begin]);
+  }
+  for (auto& worker : _searches)
+  {
+    priv.num_calls_to_run += worker->priv->num_calls_to_run;
+    worker->priv->num_calls_to_run = 0;
+  }
+}
+
+void rollout_workers::run(size_t id)
+{
+  search& sch = *_searches[id];
+  search_private& priv = *sch.priv;
+  uint64_t round = 0;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _work_cv.wait(lock, [this, round] { return _stop || _round != round; });
+      if (_stop) { return; }
+      round = _round;
+    }
+
+    try
+    {
+      for (size_t a = _next_action++; a < _end; a = _next_action++)
+      {
+        reset_search_structure(priv);
+        priv.state = SearchState::LEARN;
+        priv.learn_t = _learn_t;
+        priv.learn_a_idx = a;
+        if (_checkpoint) { continue_from_checkpoint(sch, *_checkpoint); }
+        run_task(sch, *_ec_seq);
+        _losses[a - _begin] = priv.learn_loss;
+      }
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_error) { _error = std::current_exception(); }
+      _next_action = _end;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _busy--;
+    }
+    _done_cv.notify_all();
+  }
+}
+
 template <bool is_learn>
 void train_single_example(search& sch, bool is_test_ex, bool is_holdout_ex, VW::multi_ex& ec_seq)
 {
@@ -2211,6 +2492,9 @@ void train_single_example(search& sch, bool is_test_ex, bool is_holdout_ex, VW::
   cdbg << "======================================== LEARN (" << priv.current_policy << ","
        << priv.read_example_last_pass << ") ========================================" << endl;
   priv.T = priv.metatask ? priv.meta_t : priv.t;
+  clear_rollout_checkpoints(priv);
+  sch.checkpoint_data = nullptr;
+  if (priv.rollout_pool) { priv.rollout_pool->sync(sch); }
   get_training_timesteps(priv, priv.timesteps);
   cdbg << "train_trajectory.size() = " << priv.train_trajectory.size() << ":\t";
   cdbg_print_array<scored_action>("", priv.train_trajectory);
@@ -2246,6 +2530,7 @@ void train_single_example(search& sch, bool is_test_ex, bool is_holdout_ex, VW::
     reset_search_structure(priv);  // TODO remove this?
     bool skipped_all_actions = true;
     priv.learn_a_idx = 0;
+    priv.learn_valid_action_cnt = 0;
     priv.done_with_all_actions = false;
     // for each action, roll out to get a loss
     while (!priv.done_with_all_actions)
@@ -2261,7 +2546,30 @@ void train_single_example(search& sch, bool is_test_ex, bool is_holdout_ex, VW::
       priv.learn_t = priv.timesteps[tid];
       cdbg << "-------------------------------------------------------------------------------------" << endl;
       cdbg << "learn_t = " << priv.learn_t << ", learn_a_idx = " << priv.learn_a_idx << endl;
-      run_task(sch, ec_seq);
+      // the first rollout tells how many actions there are. the workers then take all but the last one, which is
+      // rolled out here because it leaves the copy of the example at learn_t behind. every rollout reseeds its prng
+      // in reset_search_structure, so the workers draw what the serial loop would, and rolling out the last action
+      // here leaves the prng of this thread in the same state as after the serial loop
+      size_t first_parallel_a = priv.learn_a_idx;
+      bool parallel = priv.rollout_pool && (first_parallel_a > 0) &&
+          (first_parallel_a + 1 < priv.learn_valid_action_cnt);
+      const rollout_checkpoint* checkpoint = priv.use_checkpoints ? find_checkpoint(priv, priv.learn_t) : nullptr;
+      if (parallel)
+      {
+        priv.rollout_pool->start(priv, ec_seq, first_parallel_a, priv.learn_valid_action_cnt - 1, checkpoint);
+        priv.learn_a_idx = priv.learn_valid_action_cnt - 1;
+      }
+      if (checkpoint) { continue_from_checkpoint(sch, *checkpoint); }
+      try
+      {
+        run_task(sch, ec_seq);
+      }
+      catch (...)
+      {
+        if (parallel) { priv.rollout_pool->wait(); }
+        throw;
+      }
+      if (parallel) { priv.rollout_pool->finish(priv); }
       float this_loss = priv.learn_loss;
       cs_cost_push_back(priv.cb_learner, priv.learn_losses,
           priv.is_ldf ? static_cast<uint32_t>(priv.learn_a_idx - 1) : static_cast<uint32_t>(priv.learn_a_idx),
@@ -2644,6 +2952,8 @@ base_learner* setup(VW::setup_base_i& stack_builder)
   uint64_t history_length;
   uint64_t rollout_num_steps;
   uint64_t save_every_k_runs;
+  uint64_t rollout_threads;
+  bool no_rollout_checkpoints = false;
 
   uint32_t search_trained_nb_policies;
   std::string search_allowed_transitions;
@@ -2670,6 +2980,10 @@ base_learner* setup(VW::setup_base_i& stack_builder)
       .add(make_option("search_rollout", rollout_string)
                .one_of({"policy", "learn", "oracle", "ref", "mix_per_state", "mix_per_roll", "mix", "none"})
                .help("How should rollouts be executed"))
+      .add(make_option("search_rollout_threads", rollout_threads)
+               .default_value(1)
+               .help("Number of threads that run the rollouts of a time step. Needs --search_rollout oracle and a "
+                     "task that supports it (sequence, sequence_ctg, dep_parser)"))
       .add(make_option("search_rollin", rollin_string)
                .one_of({"policy", "learn", "oracle", "ref", "mix_per_state", "mix_per_roll", "mix"})
                .help("How should past trajectories be generated"))
@@ -2706,6 +3020,9 @@ base_learner* setup(VW::setup_base_i& stack_builder)
                .help("Some tasks allow you to specify how much history their depend on; specify that here"))
       .add(make_option("search_no_caching", priv.no_caching)
                .help("Turn off the built-in caching ability (makes things slower, but technically more safe)"))
+      .add(make_option("search_no_rollout_checkpoints", no_rollout_checkpoints)
+               .help("Replay the training trajectory from the start in every rollout, even if the task can "
+                     "continue from a checkpoint"))
       .add(make_option("search_xv", priv.xv).help("Train two separate policies, alternating prediction/learning"))
       .add(make_option("search_perturb_oracle", priv.perturb_oracle)
                .default_value(0.f)
@@ -2901,6 +3218,24 @@ base_learner* setup(VW::setup_base_i& stack_builder)
   if (priv.metatask && priv.metatask->initialize) { priv.metatask->initialize(*sch.get(), priv.A, options); }
   priv.meta_t = 0;
 
+  priv.use_checkpoints = priv.task && priv.task->save_checkpoint && !priv.metatask && !no_rollout_checkpoints;
+
+  if (rollout_threads > 1)
+  {
+    // rollouts that call the base learner would share its state, so only oracle rollouts run on other threads
+    if (priv.rollout_method != RollMethod::ORACLE)
+    { THROW("--search_rollout_threads requires --search_rollout oracle"); }
+    if (priv.cb_learner || priv.active_csoaa || priv.metatask)
+    { THROW("--search_rollout_threads cannot be used with --cb, --cs_active or --search_metatask"); }
+    if (priv.task && !priv.task->copy_task_data)
+    { THROW("--search_task " << task_string << " does not support --search_rollout_threads"); }
+    if (priv.task)
+    {
+      priv.rollout_pool =
+          VW::make_unique<rollout_workers>(*sch, VW::cast_to_smaller_type<size_t>(rollout_threads) - 1);
+    }
+  }
+
   VW::label_type_t expected_label_type = all.example_parser->lbl_parser.label_type;
 
   if (options.was_supplied("search_allowed_transitions"))
@@ -2974,6 +3309,7 @@ action search::predict(VW::example& ec, ptag mytag, const action* oracle_actions
     const float* allowed_actions_cost, size_t learner_id, float weight)
 {
   float a_cost = 0.;
+  if (priv->use_checkpoints) { save_checkpoint(*this); }
   action a = search_predict(*priv, &ec, 1, mytag, oracle_actions, oracle_actions_cnt, condition_on, condition_on_names,
       allowed_actions, allowed_actions_cnt, allowed_actions_cost, learner_id, a_cost, weight);
   if (priv->state == SearchState::INIT_TEST) { priv->test_action_sequence.push_back(a); }
@@ -3013,6 +3349,7 @@ action search::predictLDF(VW::example* ecs, size_t ec_cnt, ptag mytag, const act
     float weight)
 {
   float a_cost = 0.;
+  if (priv->use_checkpoints) { save_checkpoint(*this); }
   // TODO: action costs for ldf
   action a = search_predict(*priv, ecs, ec_cnt, mytag, oracle_actions, oracle_actions_cnt, condition_on,
       condition_on_names, nullptr, 0, nullptr, learner_id, a_cost, weight);
@@ -3049,6 +3386,8 @@ void search::loss(float loss) { search_declare_loss(*this->priv, loss); }
 
 bool search::predictNeedsExample() { return search_predictNeedsExample(*this->priv); }
 
+size_t search::get_checkpoint_t() { return this->priv->checkpoint_t; }
+
 std::stringstream& search::output()
 {
   if (!this->priv->should_produce_string) { return *(this->priv->bad_string_stream); }
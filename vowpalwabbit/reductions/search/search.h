@@ -104,6 +104,15 @@ struct search
     return static_cast<T*>(metatask_data.get());
   }
 
+  // for tasks with save_checkpoint: the time step run continues from (0 when it starts from the beginning) and what
+  // save_checkpoint returned at that step. the data is shared by the rollouts, so copy it rather than change it
+  size_t get_checkpoint_t();
+  template <class T>
+  const T* get_checkpoint_data()
+  {
+    return static_cast<const T*>(checkpoint_data.get());
+  }
+
   // for setting programmatic options during initialization
   // this should be an or ("|") of AUTO_CONDITION_FEATURES, etc.
   void set_options(uint32_t opts);
@@ -215,8 +224,9 @@ struct search
 
   // internal data that you don't get to see!
   search_private* priv = nullptr;
-  std::shared_ptr<void> task_data = nullptr;      // your task data!
-  std::shared_ptr<void> metatask_data = nullptr;  // your metatask data!
+  std::shared_ptr<void> task_data = nullptr;        // your task data!
+  std::shared_ptr<void> metatask_data = nullptr;    // your metatask data!
+  std::shared_ptr<void> checkpoint_data = nullptr;  // task state of the checkpoint run continues from
   const char* task_name = nullptr;
   const char* metatask_name = nullptr;
 
@@ -238,6 +248,13 @@ struct search_task
   void (*finish)(search&);
   void (*run_setup)(search&, VW::multi_ex&);
   void (*run_takedown)(search&, VW::multi_ex&);
+  // gives a second search object what run needs to roll out on another thread: share the task data that stays
+  // read-only during run and copy the rest. tasks without it cannot use --search_rollout_threads
+  void (*copy_task_data)(search& from, search& to);
+  // lets LEARN rollouts continue from a checkpoint on the training trajectory instead of replaying it from the start.
+  // called right before the prediction at a time step, it returns what run needs to continue from that step (may be
+  // nullptr). run then starts at sch.get_checkpoint_t() with sch.get_checkpoint_data<T>()
+  std::shared_ptr<void> (*save_checkpoint)(search&);
 };
 
 struct search_metatask
@@ -21,7 +21,7 @@ using namespace VW::config;
 
 namespace DepParserTask
 {
-Search::search_task task = {"dep_parser", run, initialize, nullptr, setup, nullptr};
+Search::search_task task = {"dep_parser", run, initialize, nullptr, setup, nullptr, copy_task_data, nullptr};
 }
 
 struct task_data
@@ -626,6 +626,33 @@ void setup(Search::search& sch, VW::multi_ex& ec)
   for (size_t i = 0; i < 6; i++) { data->children[i].resize_but_with_stl_behavior(n + static_cast<size_t>(1)); }
 }
 
+// run only reads the settings and the gold parse set up by setup, everything else is scratch space of its own
+void copy_task_data(Search::search& from, Search::search& to)
+{
+  const task_data* src = from.get_task_data<task_data>();
+  task_data* data = to.get_task_data<task_data>();
+  if (data == nullptr)
+  {
+    data = new task_data();
+    to.set_task_data<task_data>(data);
+    data->action_loss.resize_but_with_stl_behavior(src->action_loss.size());
+    data->ex.indices = src->ex.indices;
+    data->ex.interactions = src->ex.interactions;
+    data->ex.extent_interactions = src->ex.extent_interactions;
+    data->root_label = src->root_label;
+    data->num_label = src->num_label;
+    data->old_style_labels = src->old_style_labels;
+    data->cost_to_go = src->cost_to_go;
+    data->one_learner = src->one_learner;
+    data->transition_system = src->transition_system;
+  }
+  data->gold_heads = src->gold_heads;
+  data->gold_tags = src->gold_tags;
+  data->heads.resize_but_with_stl_behavior(src->heads.size());
+  data->tags.resize_but_with_stl_behavior(src->tags.size());
+  for (size_t i = 0; i < 6; i++) { data->children[i].resize_but_with_stl_behavior(src->children[i].size()); }
+}
+
 void run(Search::search& sch, VW::multi_ex& ec)
 {
   task_data* data = sch.get_task_data<task_data>();
@@ -9,5 +9,6 @@ namespace DepParserTask
 void initialize(Search::search&, size_t&, VW::config::options_i&);
 void run(Search::search&, VW::multi_ex&);
 void setup(Search::search&, VW::multi_ex&);
+void copy_task_data(Search::search&, Search::search&);
 extern Search::search_task task;
 }  // namespace DepParserTask
@@ -17,7 +17,7 @@ constexpr size_t NUM_LDF_ENTITY_EXAMPLES = 10;
 
 namespace EntityRelationTask
 {
-Search::search_task task = {"entity_relation", run, initialize, nullptr, nullptr, nullptr};
+Search::search_task task = {"entity_relation", run, initialize, nullptr, nullptr, nullptr, nullptr, nullptr};
 }
 
 namespace EntityRelationTask
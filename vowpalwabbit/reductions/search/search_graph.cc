@@ -62,7 +62,7 @@ instance "n1 n2 n3 0 n4 | ..." is the same as "n1 n2 n3 n4 | ...", but
 
 namespace GraphTask
 {
-Search::search_task task = {"graph", run, initialize, nullptr, setup, takedown};
+Search::search_task task = {"graph", run, initialize, nullptr, setup, takedown, nullptr, save_checkpoint};
 
 struct task_data
 {
@@ -388,9 +388,20 @@ void run(Search::search& sch, VW::multi_ex& ec)
 {
   task_data& D = *sch.get_task_data<task_data>();
   float loss_val = 0.5f / static_cast<float>(D.num_loops);
-  for (size_t n = 0; n < D.N; n++) { D.pred[n] = D.K + 1; }
+  // every loop makes one prediction per node, so a checkpoint at time step t is node t % N of loop t / N
+  size_t first_t = sch.get_checkpoint_t();
+  size_t first_loop = 0;
+  if (first_t > 0)
+  {
+    D.pred = *sch.get_checkpoint_data<std::vector<size_t>>();
+    first_loop = first_t / D.N;
+  }
+  else
+  {
+    for (size_t n = 0; n < D.N; n++) { D.pred[n] = D.K + 1; }
+  }
 
-  for (size_t loop = 0; loop < D.num_loops; loop++)
+  for (size_t loop = first_loop; loop < D.num_loops; loop++)
   {
     bool last_loop = loop == (D.num_loops - 1);
     int start = 0;
@@ -402,6 +413,7 @@ void run(Search::search& sch, VW::multi_ex& ec)
       end = -1;
       step = -1;
     }  // go inward on odd loops
+    if ((first_t > 0) && (loop == first_loop)) { start += step * static_cast<int>(first_t % D.N); }
     for (int n_id = start; n_id != end; n_id += step)
     {
       uint32_t n = D.bfs[n_id];
@@ -450,4 +462,9 @@ void run(Search::search& sch, VW::multi_ex& ec)
     for (uint32_t n = 0; n < D.N; n++) { sch.output() << D.pred[n] << ' '; }
   }
 }
+
+std::shared_ptr<void> save_checkpoint(Search::search& sch)
+{
+  return std::make_shared<std::vector<size_t>>(sch.get_task_data<task_data>()->pred);
+}
 }  // namespace GraphTask
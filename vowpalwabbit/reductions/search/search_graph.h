@@ -10,5 +10,6 @@ void initialize(Search::search&, size_t&, VW::config::options_i&);
 void setup(Search::search&, VW::multi_ex&);
 void run(Search::search&, VW::multi_ex&);
 void takedown(Search::search&, VW::multi_ex&);
+std::shared_ptr<void> save_checkpoint(Search::search&);
 extern Search::search_task task;
 }  // namespace GraphTask
@@ -11,7 +11,7 @@ using namespace VW::config;
 // it can be used for any foreign library too!
 namespace HookTask
 {
-Search::search_task task = {"hook", run, initialize, nullptr, run_setup, run_takedown};
+Search::search_task task = {"hook", run, initialize, nullptr, run_setup, run_takedown, nullptr, nullptr};
 
 void initialize(Search::search& sch, size_t& num_actions, options_i& arg)
 {
@@ -7,7 +7,7 @@
 
 namespace MulticlassTask
 {
-Search::search_task task = {"multiclasstask", run, initialize, nullptr, nullptr, nullptr};
+Search::search_task task = {"multiclasstask", run, initialize, nullptr, nullptr, nullptr, nullptr, nullptr};
 }
 
 namespace MulticlassTask
@@ -12,23 +12,24 @@ using namespace VW::config;
 
 namespace SequenceTask
 {
-Search::search_task task = {"sequence", run, initialize, nullptr, nullptr, nullptr};
+Search::search_task task = {"sequence", run, initialize, nullptr, nullptr, nullptr, copy_task_data, save_checkpoint};
 }
 namespace SequenceSpanTask
 {
-Search::search_task task = {"sequencespan", run, initialize, nullptr, setup, takedown};
+Search::search_task task = {"sequencespan", run, initialize, nullptr, setup, takedown, nullptr, nullptr};
 }
 namespace SequenceTaskCostToGo
 {
-Search::search_task task = {"sequence_ctg", run, initialize, nullptr, nullptr, nullptr};
+Search::search_task task = {
+    "sequence_ctg", run, initialize, nullptr, nullptr, nullptr, copy_task_data, save_checkpoint};
 }
 namespace ArgmaxTask
 {
-Search::search_task task = {"argmax", run, initialize, nullptr, nullptr, nullptr};
+Search::search_task task = {"argmax", run, initialize, nullptr, nullptr, nullptr, nullptr, nullptr};
 }
 namespace SequenceTask_DemoLDF
 {
-Search::search_task task = {"sequence_demoldf", run, initialize, nullptr, nullptr, nullptr};
+Search::search_task task = {"sequence_demoldf", run, initialize, nullptr, nullptr, nullptr, nullptr, nullptr};
 }
 
 namespace SequenceTask
@@ -44,7 +45,7 @@ void initialize(Search::search& sch, size_t& /*num_actions*/, options_i& /*optio
 void run(Search::search& sch, VW::multi_ex& ec)
 {
   Search::predictor P(sch, static_cast<ptag>(0));
-  for (size_t i = 0; i < ec.size(); i++)
+  for (size_t i = sch.get_checkpoint_t(); i < ec.size(); i++)
   {
     action oracle = ec[i]->l.multi.label;
     size_t prediction = P.set_tag(static_cast<ptag>(i) + 1)
@@ -56,6 +57,12 @@ void run(Search::search& sch, VW::multi_ex& ec)
     if (sch.output().good()) { sch.output() << sch.pretty_label(static_cast<uint32_t>(prediction)) << ' '; }
   }
 }
+
+// there is no task data, so any number of rollouts can run at once
+void copy_task_data(Search::search& /* from */, Search::search& /* to */) {}
+
+// the i-th prediction is time step i, so there is nothing to remember
+std::shared_ptr<void> save_checkpoint(Search::search& /* sch */) { return nullptr; }
 }  // namespace SequenceTask
 
 namespace SequenceSpanTask
@@ -299,7 +306,7 @@ void run(Search::search& sch, VW::multi_ex& ec)
   size_t K = *sch.get_task_data<size_t>();
   float* costs = calloc_or_throw<float>(K);
   Search::predictor P(sch, static_cast<ptag>(0));
-  for (size_t i = 0; i < ec.size(); i++)
+  for (size_t i = sch.get_checkpoint_t(); i < ec.size(); i++)
   {
     action oracle = ec[i]->l.multi.label;
     for (size_t k = 0; k < K; k++) { costs[k] = 1.; }
@@ -313,6 +320,10 @@ void run(Search::search& sch, VW::multi_ex& ec)
   }
   free(costs);
 }
+
+void copy_task_data(Search::search& from, Search::search& to) { to.task_data = from.task_data; }
+
+std::shared_ptr<void> save_checkpoint(Search::search& /* sch */) { return nullptr; }
 }  // namespace SequenceTaskCostToGo
 
 namespace ArgmaxTask
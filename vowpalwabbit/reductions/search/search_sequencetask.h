@@ -8,6 +8,8 @@ namespace SequenceTask
 {
 void initialize(Search::search&, size_t&, VW::config::options_i&);
 void run(Search::search&, VW::multi_ex&);
+void copy_task_data(Search::search&, Search::search&);
+std::shared_ptr<void> save_checkpoint(Search::search&);
 extern Search::search_task task;
 }  // namespace SequenceTask
 
@@ -25,6 +27,8 @@ namespace SequenceTaskCostToGo
 {
 void initialize(Search::search&, size_t&, VW::config::options_i&);
 void run(Search::search&, VW::multi_ex&);
+void copy_task_data(Search::search&, Search::search&);
+std::shared_ptr<void> save_checkpoint(Search::search&);
 extern Search::search_task task;
 }  // namespace SequenceTaskCostToGo
 
@@ -30,7 +30,9 @@ struct client
 struct partial
 {
   client* nodes;
+  bool* wants_epoch;
   size_t filled;
+  size_t epoch;
 };
 
 static int socket_sort(const void* s1, const void* s2)
@@ -82,6 +84,18 @@ void fail_send(const socket_t fd, const void* buf, const int count)
   if (send(fd, (char*)buf, count, 0) == -1) THROWERRNO("send: ");
 }
 
+// Nodes send nothing while they wait for the tree, so a readable socket means the node has gone away.
+bool still_connected(const socket_t fd)
+{
+  fd_set fds;
+  FD_ZERO(&fds);
+  FD_SET(fd, &fds);
+  timeval no_wait = {0, 0};
+  if (select(static_cast<int>(fd) + 1, &fds, nullptr, nullptr, &no_wait) <= 0) { return true; }
+  char byte;
+  return recv(fd, &byte, sizeof(byte), MSG_PEEK) > 0;
+}
+
 namespace VW
 {
 SpanningTree::SpanningTree(uint16_t port, bool quiet) : m_stop(false), m_port(port), m_future(nullptr), m_quiet(quiet)
@@ -158,6 +172,10 @@ void SpanningTree::Stop()
 void SpanningTree::Run()
 {
   std::map<size_t, partial> partial_nodesets;
+  // Membership epoch of the next tree built for each nonce whose nodes requested epochs. Nodes that lost a member
+  // register again and get a new tree with the replacement in the next epoch. Node 0 removes the entry of its job when
+  // the job is done.
+  std::map<size_t, size_t> next_epochs;
   while (!m_stop)
   {
     if (listen(sock, 1024) < 0) THROWERRNO("listen: ");
@@ -215,6 +233,17 @@ void SpanningTree::Run()
       if (!m_quiet)
       { std::cerr << dotted_quad << "(" << hostname << ':' << ntohs(m_port) << "): node id=" << id << std::endl; }
     }
+    const bool wants_epoch = (id & SPAN_REQUEST_EPOCH) != 0;
+    const bool job_finished = (id & SPAN_JOB_FINISHED) != 0;
+    id &= ~(SPAN_REQUEST_EPOCH | SPAN_JOB_FINISHED);
+
+    if (job_finished)
+    {
+      if (!m_quiet) { std::cerr << "nonce " << nonce << ": job finished, forgetting its epochs" << std::endl; }
+      next_epochs.erase(nonce);
+      CLOSESOCK(f);
+      continue;
+    }
 
     int ok = true;
     if (id >= total)
@@ -231,8 +260,11 @@ void SpanningTree::Run()
     if (partial_nodesets.find(nonce) == partial_nodesets.end())
     {
       partial_nodeset.nodes = static_cast<client*>(calloc(total, sizeof(client)));
+      partial_nodeset.wants_epoch = static_cast<bool*>(calloc(total, sizeof(bool)));
       for (size_t i = 0; i < total; i++) { partial_nodeset.nodes[i].client_ip = static_cast<uint32_t>(-1); }
       partial_nodeset.filled = 0;
+      const auto next_epoch = next_epochs.find(nonce);
+      partial_nodeset.epoch = next_epoch == next_epochs.end() ? 0 : next_epoch->second;
     }
     else
     {
@@ -240,13 +272,30 @@ void SpanningTree::Run()
       partial_nodesets.erase(nonce);
     }
 
-    if (ok && partial_nodeset.nodes[id].client_ip != static_cast<uint32_t>(-1)) { ok = false; }
+    if (ok && partial_nodeset.nodes[id].client_ip != static_cast<uint32_t>(-1))
+    {
+      // A node that died while waiting for the tree is replaced by the new connection.
+      if (still_connected(partial_nodeset.nodes[id].socket)) { ok = false; }
+      else
+      {
+        if (!m_quiet)
+        {
+          std::cerr << "nonce " << nonce << ": node " << id << " disconnected while waiting, replacing it"
+                    << std::endl;
+        }
+        CLOSESOCK(partial_nodeset.nodes[id].socket);
+        partial_nodeset.nodes[id].client_ip = static_cast<uint32_t>(-1);
+        partial_nodeset.filled--;
+      }
+    }
     fail_send(f, &ok, sizeof(ok));
 
     if (ok)
     {
+      if (wants_epoch) { fail_send(f, &partial_nodeset.epoch, sizeof(partial_nodeset.epoch)); }
       partial_nodeset.nodes[id].client_ip = client_address.sin_addr.s_addr;
       partial_nodeset.nodes[id].socket = f;
+      partial_nodeset.wants_epoch[id] = wants_epoch;
       partial_nodeset.filled++;
     }
     if (partial_nodeset.filled != total)  // Need to wait for more connections
@@ -268,6 +317,14 @@ void SpanningTree::Run()
     else
     {
       // Time to make the spanning tree
+      bool any_wants_epoch = false;
+      for (size_t i = 0; i < total; i++) { any_wants_epoch = any_wants_epoch || partial_nodeset.wants_epoch[i]; }
+      if (any_wants_epoch)
+      {
+        next_epochs[nonce] = partial_nodeset.epoch + 1;
+        if (!m_quiet)
+        { std::cerr << "nonce " << nonce << ": building tree for epoch " << partial_nodeset.epoch << std::endl; }
+      }
       qsort(partial_nodeset.nodes, total, sizeof(client), socket_sort);
 
       int* parent = static_cast<int*>(calloc(total, sizeof(int)));
@@ -310,6 +367,7 @@ void SpanningTree::Run()
       }
       free(client_ports);
       free(partial_nodeset.nodes);
+      free(partial_nodeset.wants_epoch);
       free(parent);
       free(kid_count);
     }
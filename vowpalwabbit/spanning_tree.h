@@ -44,8 +44,18 @@ typedef int socket_t;
 #  include <future>
 #endif
 
+#include <cstddef>
+
 namespace VW
 {
+// Flags a node sets in the node id it sends to the span server. A span server that does not know them sees an invalid
+// id and refuses the node, so nodes only set them when they need them.
+// The node wants the membership epoch of its tree, which the server sends right after ok.
+constexpr size_t SPAN_REQUEST_EPOCH = static_cast<size_t>(1) << (sizeof(size_t) * 8 - 1);
+// Sent by node 0 of a job that requested epochs once it is done. The server forgets the epochs of the job and
+// replies nothing.
+constexpr size_t SPAN_JOB_FINISHED = static_cast<size_t>(1) << (sizeof(size_t) * 8 - 2);
+
 class SpanningTree
 {
 private:
@@ -141,6 +141,9 @@ void dealloc_examples(example* example_ptr, size_t count);
 void parse_example_label(VW::workspace& all, example& ec, const std::string& label);
 void setup_examples(VW::workspace& all, v_array<example*>& examples);
 void setup_example(VW::workspace& all, example* ae);
+// Prepares ae for a prediction only: unlike setup_example it does not count the example as parsed, takes no part in
+// the holdout set and is never written to the cache.
+void setup_example_for_predict(VW::workspace& all, example* ae);
 example* new_unused_example(VW::workspace& all);
 example* get_example(parser* pf);
 float get_topic_prediction(example* ec, size_t i);  // i=0 to max topic -1
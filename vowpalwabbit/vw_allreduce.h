@@ -10,8 +10,9 @@
 
 #include <cstddef>
 
+// Reduces buffer[i * stride] for i < n over all nodes, in place.
 template <class T, void (*f)(T&, const T&)>
-void all_reduce(VW::workspace& all, T* buffer, const size_t n)
+void all_reduce(VW::workspace& all, T* buffer, const size_t n, const size_t stride = 1)
 {
   switch (all.all_reduce_type)
   {
@@ -19,14 +20,21 @@ void all_reduce(VW::workspace& all, T* buffer, const size_t n)
     {
       auto* all_reduce_sockets_ptr = dynamic_cast<AllReduceSockets*>(all.all_reduce);
       if (all_reduce_sockets_ptr == nullptr) { THROW("all_reduce was not a AllReduceSockets* object") }
-      all_reduce_sockets_ptr->all_reduce<T, f>(buffer, n, all.logger);
+      all_reduce_sockets_ptr->all_reduce<T, f>(buffer, n, stride, all.logger);
       break;
     }
     case AllReduceType::Thread:
     {
       auto* all_reduce_threads_ptr = dynamic_cast<AllReduceThreads*>(all.all_reduce);
       if (all_reduce_threads_ptr == nullptr) { THROW("all_reduce was not a AllReduceThreads* object") }
-      all_reduce_threads_ptr->all_reduce<T, f>(buffer, n);
+      all_reduce_threads_ptr->all_reduce<T, f>(buffer, n, stride);
+      break;
+    }
+    case AllReduceType::SharedMemory:
+    {
+      auto* all_reduce_shared_memory_ptr = dynamic_cast<AllReduceSharedMemory*>(all.all_reduce);
+      if (all_reduce_shared_memory_ptr == nullptr) { THROW("all_reduce was not a AllReduceSharedMemory* object") }
+      all_reduce_shared_memory_ptr->all_reduce<T, f>(buffer, n, stride, all.logger);
       break;
     }
   }
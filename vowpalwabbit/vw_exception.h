@@ -126,6 +126,22 @@ public:
   ~strict_parse_exception() noexcept override = default;
 };
 
+// The nodes of a rebuilt spanning tree are not at the same synchronization point, retrying cannot help.
+class allreduce_rejoin_exception : public vw_exception
+{
+public:
+  allreduce_rejoin_exception(const char* file, int lineNumber, const std::string& message)
+      : vw_exception(file, lineNumber, message)
+  {
+  }
+
+  allreduce_rejoin_exception(const allreduce_rejoin_exception& ex) = default;
+  allreduce_rejoin_exception& operator=(const allreduce_rejoin_exception& other) = default;
+  allreduce_rejoin_exception(allreduce_rejoin_exception&& ex) noexcept = default;
+  allreduce_rejoin_exception& operator=(allreduce_rejoin_exception&& other) noexcept = default;
+  ~allreduce_rejoin_exception() noexcept override = default;
+};
+
 inline std::string strerror_to_string(int error_number)
 {
 #  ifdef _WIN32
@@ -11,6 +11,7 @@
 #include "simple_label.h"
 #include "vw.h"
 
+#include <array>
 #include <codecvt>
 #include <locale>
 #include <memory>
@@ -359,6 +360,83 @@ extern "C"
     return VW::get_cost_sensitive_prediction(ex);
   }
 
+  struct predict_batch
+  {
+    VW::workspace* all;
+    VW::example ec;
+    std::array<bool, 256> used_namespaces;
+  };
+
+  VW_DLL_PUBLIC VW_PREDICT_BATCH VW_CALLING_CONV VW_CreatePredictBatch(VW_HANDLE handle)
+  {
+    auto* pointer = static_cast<VW::workspace*>(handle);
+    const auto prediction_type = pointer->l->get_output_prediction_type();
+    if (pointer->l->is_multiline() ||
+        (prediction_type != VW::prediction_type_t::scalar && prediction_type != VW::prediction_type_t::prob &&
+            prediction_type != VW::prediction_type_t::multiclass))
+    {
+      pointer->logger.err_error("VW_PredictBatch supports single line learners predicting a scalar or a class, not {}",
+          VW::to_string(prediction_type));
+      return nullptr;
+    }
+
+    auto* batch = new predict_batch;
+    batch->all = pointer;
+    batch->used_namespaces.fill(false);
+    pointer->example_parser->lbl_parser.default_label(batch->ec.l);
+    return static_cast<VW_PREDICT_BATCH>(batch);
+  }
+
+  VW_DLL_PUBLIC void VW_CALLING_CONV VW_FreePredictBatch(VW_PREDICT_BATCH batch)
+  {
+    delete static_cast<predict_batch*>(batch);
+  }
+
+  VW_DLL_PUBLIC int VW_CALLING_CONV VW_PredictBatch(VW_PREDICT_BATCH batch, size_t num_examples,
+      const size_t* feature_offsets, const unsigned char* namespaces, const size_t* feature_hashes,
+      const float* feature_values, float* predictions)
+  {
+    auto* b = static_cast<predict_batch*>(batch);
+    auto& all = *b->all;
+    auto& ec = b->ec;
+    auto* learner = VW::LEARNER::as_singleline(all.l);
+    const bool multiclass = learner->get_output_prediction_type() == VW::prediction_type_t::multiclass;
+
+    // Exceptions must not leave the C API, the error is logged and reported by the return value instead.
+    try
+    {
+      for (size_t i = 0; i < num_examples; i++)
+      {
+        for (size_t j = feature_offsets[i]; j < feature_offsets[i + 1]; j++)
+        {
+          const unsigned char ns = namespaces[j];
+          if (!b->used_namespaces[ns])
+          {
+            b->used_namespaces[ns] = true;
+            ec.indices.push_back(ns);
+          }
+          ec.feature_space[ns].push_back(feature_values[j], feature_hashes[j]);
+        }
+        for (auto ns : ec.indices) { b->used_namespaces[ns] = false; }
+        // Not a parsed example: no parser counters, holdout or cache write.
+        VW::setup_example_for_predict(all, &ec);
+
+        learner->predict(ec);
+        predictions[i] = multiclass ? static_cast<float>(ec.pred.multiclass) : ec.pred.scalar;
+
+        VW::empty_example(all, ec);
+      }
+    }
+    catch (const std::exception& e)
+    {
+      all.logger.err_error("VW_PredictBatch: {}", e.what());
+      for (auto ns : ec.indices) { b->used_namespaces[ns] = false; }
+      VW::empty_example(all, ec);
+      return 0;
+    }
+    return 1;
+  }
+
   VW_DLL_PUBLIC float VW_CALLING_CONV VW_Get_Weight(VW_HANDLE handle, size_t index, size_t offset)
   {
     auto* pointer = static_cast<VW::workspace*>(handle);
@@ -41,6 +41,7 @@ extern "C"
   typedef void* VW_FEATURE_SPACE;
   typedef void* VW_FEATURE;
   typedef void* VW_IOBUF;
+  typedef void* VW_PREDICT_BATCH;
 
   const VW_HANDLE INVALID_VW_HANDLE = VW_TYPE_SAFE_NULL;
   const VW_HANDLE INVALID_VW_EXAMPLE = VW_TYPE_SAFE_NULL;
@@ -115,6 +116,22 @@ extern "C"
   VW_DLL_PUBLIC float VW_CALLING_CONV VW_Learn(VW_HANDLE handle, VW_EXAMPLE e);
   VW_DLL_PUBLIC float VW_CALLING_CONV VW_Predict(VW_HANDLE handle, VW_EXAMPLE e);
   VW_DLL_PUBLIC float VW_CALLING_CONV VW_PredictCostSensitive(VW_HANDLE handle, VW_EXAMPLE e);
+
+  // Batched prediction from pre-hashed features. A batch owns the example it reuses for every prediction, so once
+  // its feature arrays have grown to the largest example no call allocates. A batch must not be used concurrently
+  // with other calls on the same handle. Returns null if the learner is multiline or predicts neither a scalar nor
+  // a class.
+  VW_DLL_PUBLIC VW_PREDICT_BATCH VW_CALLING_CONV VW_CreatePredictBatch(VW_HANDLE handle);
+  VW_DLL_PUBLIC void VW_CALLING_CONV VW_FreePredictBatch(VW_PREDICT_BATCH batch);
+  // Predicts num_examples examples. The features of example i are the triples at positions feature_offsets[i] to
+  // feature_offsets[i + 1] - 1 of namespaces (namespace index, as set by VW_SetFeatureSpace), feature_hashes (as
+  // returned by VW_HashFeature) and feature_values, so feature_offsets has num_examples + 1 entries. Writes the
+  // scalar prediction of each example, or the predicted class for multiclass learners, to predictions. The examples
+  // are only predicted: they are not counted, held out or written to the cache. Returns 1 on success and 0 if a
+  // prediction failed, in which case the error is logged and the remaining predictions are not written.
+  VW_DLL_PUBLIC int VW_CALLING_CONV VW_PredictBatch(VW_PREDICT_BATCH batch, size_t num_examples,
+      const size_t* feature_offsets, const unsigned char* namespaces, const size_t* feature_hashes,
+      const float* feature_values, float* predictions);
   // deprecated. Please use either VW_ReadExample for parsing, or VW_ImportExample for example construction
   VW_DLL_PUBLIC void VW_CALLING_CONV VW_AddLabel(VW_EXAMPLE e, float label, float weight, float base);
   // deprecated. Please use either VW_ReadExample for parsing, or VW_ImportExample for example construction